@@ -244,6 +244,9 @@ macro(_gt_setup_targets _config_mode clang_cuda_mode)
     _gt_add_library(${_config_mode} fn_naive)
     target_link_libraries(${_gt_namespace}fn_naive INTERFACE ${_gt_namespace}gridtools)
 
+    _gt_add_library(${_config_mode} fn_cpu_blocked)
+    target_link_libraries(${_gt_namespace}fn_cpu_blocked INTERFACE ${_gt_namespace}gridtools)
+
     set(_required_nlohmann_json_version "3.10.4")
     include(get_nlohmann_json)
     get_nlohmann_json(${_required_nlohmann_json_version})
@@ -255,7 +258,7 @@ macro(_gt_setup_targets _config_mode clang_cuda_mode)
 
     set(GT_STENCILS naive)
     set(GT_REDUCTIONS naive)
-    set(GT_FN_BACKENDS naive)
+    set(GT_FN_BACKENDS naive cpu_blocked)
     set(GT_STORAGES cpu_kfirst cpu_ifirst)
     set(GT_GCL_ARCHS)
 
@@ -305,6 +308,7 @@ macro(_gt_setup_targets _config_mode clang_cuda_mode)
 
     if (OpenMP_CXX_FOUND)
         target_link_libraries(${_gt_namespace}fn_naive INTERFACE OpenMP::OpenMP_CXX)
+        target_link_libraries(${_gt_namespace}fn_cpu_blocked INTERFACE OpenMP::OpenMP_CXX)
 
         _gt_add_library(${_config_mode} stencil_cpu_kfirst)
         target_link_libraries(${_gt_namespace}stencil_cpu_kfirst INTERFACE ${_gt_namespace}gridtools OpenMP::OpenMP_CXX)
@@ -315,6 +319,9 @@ macro(_gt_setup_targets _config_mode clang_cuda_mode)
         _gt_add_library(${_config_mode} reduction_cpu)
         target_link_libraries(${_gt_namespace}reduction_cpu INTERFACE ${_gt_namespace}gridtools OpenMP::OpenMP_CXX)
 
+        _gt_add_library(${_config_mode} reduction_cpu_deterministic)
+        target_link_libraries(${_gt_namespace}reduction_cpu_deterministic INTERFACE ${_gt_namespace}gridtools OpenMP::OpenMP_CXX)
+
         if(MPI_CXX_FOUND)
             _gt_add_library(${_config_mode} gcl_cpu)
             target_link_libraries(${_gt_namespace}gcl_cpu INTERFACE ${_gt_namespace}gridtools OpenMP::OpenMP_CXX MPI::MPI_CXX)
@@ -340,7 +347,7 @@ macro(_gt_setup_targets _config_mode clang_cuda_mode)
 
         list(APPEND GT_STENCILS cpu_kfirst cpu_ifirst)
 
-        list(APPEND GT_REDUCTIONS cpu)
+        list(APPEND GT_REDUCTIONS cpu cpu_deterministic)
 
     endif()
 
@@ -351,6 +358,12 @@ macro(_gt_setup_targets _config_mode clang_cuda_mode)
         target_link_libraries(${_gt_namespace}threadpool_hpx INTERFACE ${_gt_namespace}gridtools HPX::hpx)
     endif()
 
+    find_package(Threads QUIET)
+    if (Threads_FOUND)
+        _gt_add_library(${_config_mode} threadpool_work_stealing)
+        target_link_libraries(${_gt_namespace}threadpool_work_stealing INTERFACE ${_gt_namespace}gridtools Threads::Threads)
+    endif()
+
     set(GT_AVAILABLE_TARGETS ${_gt_available_targets} CACHE STRING "Available GridTools targets" FORCE)
     mark_as_advanced(GT_AVAILABLE_TARGETS)
 endmacro()
@@ -18,13 +18,16 @@
 #include <new>
 #include <stdexcept>
 #include <tuple>
+#include <vector>
 
 #ifdef __linux__
 #include <cstdio>
 
 #include <fcntl.h>
+#include <linux/mempolicy.h>
 #include <sys/mman.h>
 #include <sys/stat.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
 #include <unistd.h>
 #endif
@@ -40,6 +43,8 @@ namespace gridtools {
 
         enum class hugepage_mode { disabled, transparent, explicit_allocation };
 
+        enum class numa_mode { first_touch, interleave, local };
+
 #ifdef __linux__
         inline std::size_t get_sysinfo(const char *info, std::size_t default_value) {
             int fd = open(info, O_RDONLY);
@@ -80,6 +85,31 @@ namespace gridtools {
             return value;
         }
 
+        inline std::size_t get_cache_size(const char *info, std::size_t default_value) {
+            int fd = open(info, O_RDONLY);
+            if (fd != -1) {
+                char buffer[16] = {};
+                if (read(fd, buffer, sizeof(buffer) - 1) > 0) {
+                    char *suffix;
+                    std::size_t value = std::strtoull(buffer, &suffix, 10);
+                    if (*suffix == 'K')
+                        value *= 1024;
+                    else if (*suffix == 'M')
+                        value *= 1024 * 1024;
+                    if (value > 0)
+                        default_value = value;
+                }
+                close(fd);
+            }
+            return default_value;
+        }
+
+        inline std::size_t l2_cache_size() {
+            static const std::size_t value =
+                get_cache_size("/sys/devices/system/cpu/cpu0/cache/index2/size", 1024 * 1024);
+            return value;
+        }
+
         inline std::size_t hugepage_size() {
             static const std::size_t value = get_meminfo("Hugepagesize: %lu kB", 2 * 1024) * 1024;
             return value;
@@ -125,6 +155,43 @@ namespace gridtools {
             return {ptr, size};
         }
 
+        // the set of NUMA nodes the process is allowed to allocate memory on
+        inline std::vector<unsigned long> allowed_numa_nodes() {
+            std::vector<unsigned long> nodemask(1024 / (8 * sizeof(unsigned long)));
+            if (syscall(SYS_get_mempolicy,
+                    nullptr,
+                    nodemask.data(),
+                    8 * sizeof(unsigned long) * nodemask.size(),
+                    nullptr,
+                    MPOL_F_MEMS_ALLOWED))
+                nodemask.clear();
+            return nodemask;
+        }
+
+        // sets the memory policy of the (not yet touched) pages in [ptr, ptr + size); failures, e.g. on kernels without
+        // NUMA support, leave the default first touch policy in place
+        inline void bind(void *ptr, std::size_t size, numa_mode mode) {
+            switch (mode) {
+            case numa_mode::first_touch:
+                break;
+            case numa_mode::interleave: {
+                static const auto nodemask = allowed_numa_nodes();
+                if (!nodemask.empty())
+                    syscall(SYS_mbind,
+                        ptr,
+                        size,
+                        MPOL_INTERLEAVE,
+                        nodemask.data(),
+                        8 * sizeof(unsigned long) * nodemask.size(),
+                        0);
+                break;
+            }
+            case numa_mode::local:
+                syscall(SYS_mbind, ptr, size, MPOL_LOCAL, nullptr, 0, 0);
+                break;
+            }
+        }
+
         inline void deallocate(void *ptr, std::size_t size, hugepage_mode mode) {
             switch (mode) {
             case hugepage_mode::disabled:
@@ -145,6 +212,10 @@ namespace gridtools {
             return 64; // default value for (most?) x86-64 archs
         }
 
+        inline std::size_t l2_cache_size() {
+            return 1024 * 1024; // common value for current x86-64 and ARM server archs
+        }
+
         inline std::size_t hugepage_size() {
             return 2 * 1024 * 1024; // 2MB is the default on most systems
         }
@@ -162,6 +233,8 @@ namespace gridtools {
             return {ptr, size};
         }
 
+        inline void bind(void *, std::size_t, numa_mode) {}
+
         inline void deallocate(void *ptr, std::size_t, hugepage_mode) { free(ptr); }
 #endif
 
@@ -182,6 +255,18 @@ namespace gridtools {
             return hugepage_mode::transparent;
         }
 
+        inline numa_mode numa_mode_from_env() {
+            const char *env_value = std::getenv("GT_NUMA_MODE");
+            if (!env_value || std::strcmp(env_value, "first_touch") == 0)
+                return numa_mode::first_touch;
+            if (std::strcmp(env_value, "interleave") == 0)
+                return numa_mode::interleave;
+            if (std::strcmp(env_value, "local") == 0)
+                return numa_mode::local;
+            std::fprintf(stderr, "warning: env variable GT_NUMA_MODE set to invalid value '%s'\n", env_value);
+            return numa_mode::first_touch;
+        }
+
         struct ptr_metadata {
             std::size_t offset, full_size;
             hugepage_mode mode;
@@ -192,6 +277,11 @@ namespace gridtools {
     /**
      * @brief Allocates huge page memory (if GT_NO_HUGETLB is not defined) and shifts allocations by some bytes to
      * reduce cache set conflicts.
+     *
+     * The NUMA placement of the pages is chosen with the env variable GT_NUMA_MODE: `first_touch` (default) places
+     * each page on the node of the thread that touches it first, `interleave` distributes the pages round-robin over
+     * all allowed nodes and `local` binds them to the node of the first touching thread, overriding any process wide
+     * policy (e.g. of `numactl --interleave`).
      */
     inline void *hugepage_alloc(std::size_t size) {
         // get allocation offset to reduce L1 cache conflicts
@@ -204,6 +294,7 @@ namespace gridtools {
         // allocate memory with additional space for offsetting
         void *ptr;
         std::tie(ptr, size) = hugepage_alloc_impl_::allocate(size + offset, mode);
+        hugepage_alloc_impl_::bind(ptr, size, hugepage_alloc_impl_::numa_mode_from_env());
 
         // offset pointer and write pointer metadata required for deallocation
         ptr = static_cast<char *>(ptr) + offset;
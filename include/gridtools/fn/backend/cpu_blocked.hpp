@@ -0,0 +1,474 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../../common/hugepage_alloc.hpp"
+#include "../../common/hymap.hpp"
+#include "../../common/integral_constant.hpp"
+#include "../../common/tuple_util.hpp"
+#include "../../meta.hpp"
+#include "../../sid/allocator.hpp"
+#include "../../sid/blocked_dim.hpp"
+#include "../../sid/composite.hpp"
+#include "../../sid/concept.hpp"
+#include "../../sid/contiguous.hpp"
+#include "../../sid/multi_shift.hpp"
+#include "../../sid/synthetic.hpp"
+#include "../../sid/unknown_kind.hpp"
+#include "../../thread_pool/concept.hpp"
+#include "../../thread_pool/dummy.hpp"
+#include "../../thread_pool/omp.hpp"
+#include "../extents.hpp"
+#include "../simd_column_stage.hpp"
+#include "../stage_fusion.hpp"
+#include "./common.hpp"
+
+namespace gridtools::fn::backend {
+    namespace cpu_blocked_impl_ {
+        /*
+         * BlockSizes must be a meta map, mapping dimensions to integral constant block sizes, like for the gpu backend.
+         * Dimensions that are not in the map are not blocked.
+         *
+         * For example, meta::list<meta::list<dim::i, integral_constant<int, 64>>,
+         *                         meta::list<dim::j, integral_constant<int, 8>>>;
+         * When using a cartesian grid.
+         *
+         * The blocks are distributed over the threads of the thread pool. Within a block, the first dimension of the
+         * domain is the innermost loop, hence it should be the contiguous dimension of the fields (as with
+         * storage::cpu_ifirst and the temporaries of this backend).
+         *
+         * With a SimdWidth above one, column stages are evaluated on SimdWidth neighboring columns along the first
+         * dimension in lockstep (see fn/simd_column_stage.hpp); the remaining columns of a block are evaluated one by
+         * one.
+         *
+         * InnerDim selects another dimension for the innermost loop (and the contiguous dimension of the
+         * temporaries), for example the vertical dimension for fields with a vertical-contiguous layout like
+         * storage::cpu_kfirst. Then one neighbor table lookup of an unstructured stencil is shared by the whole
+         * vectorized loop along the column, so the vertical dimension should not be blocked. `void` keeps the first
+         * dimension of the domain.
+         */
+        template <class BlockSizes,
+            class ThreadPool =
+#if defined(_OPENMP) || defined(GT_HIP_OPENMP_WORKAROUND)
+                thread_pool::omp,
+#else
+                thread_pool::dummy,
+#endif
+            class SimdWidth = integral_constant<int, 1>,
+            class InnerDim = void>
+        struct cpu_blocked {
+            using block_sizes_t = BlockSizes;
+        };
+
+        template <class InnerDim, class Dims>
+        struct inner_dim_first_keys {
+            template <class Dim>
+            using is_outer = std::negation<std::is_same<Dim, InnerDim>>;
+
+            using type = meta::if_<meta::st_contains<Dims, InnerDim>,
+                meta::push_front<meta::filter<is_outer, Dims>, InnerDim>,
+                Dims>;
+        };
+
+        template <class Sizes, template <class...> class L, class... Dims>
+        auto reorder_sizes(Sizes const &sizes, L<Dims...>) {
+            return hymap::keys<Dims...>::make_values(at_key<Dims>(sizes)...);
+        }
+
+        // The sizes with InnerDim as first dimension, which is the innermost loop.
+        template <class InnerDim, class Sizes>
+        auto inner_dim_first(Sizes const &sizes) {
+            if constexpr (std::is_void_v<InnerDim>)
+                return sizes;
+            else
+                return reorder_sizes(sizes, typename inner_dim_first_keys<InnerDim, get_keys<Sizes>>::type());
+        }
+
+        template <class BlockSizes, class Dim, class Item = meta::mp_find<BlockSizes, Dim>>
+        int block_size(int size) {
+            if constexpr (std::is_void_v<Item>)
+                return size;
+            else
+                return meta::second<Item>::value;
+        }
+
+        template <class Dim, class Fun>
+        struct inner_loop_f {
+            Fun m_fun;
+            int m_size;
+
+            template <class Ptr, class Strides>
+            void operator()(Ptr &ptr, Strides const &strides) const {
+                using namespace literals;
+                auto &&stride = sid::get_stride<Dim>(strides);
+#pragma omp simd
+                for (int i = 0; i < m_size; ++i) {
+                    m_fun(ptr, strides);
+                    sid::shift(ptr, stride, 1_c);
+                }
+                sid::shift(ptr, stride, -m_size);
+            }
+        };
+
+        /*
+         * Like inner_loop_f, but calls `simd_fun(ptr, strides)`, which processes Width consecutive points, as long as
+         * there are Width points left.
+         */
+        template <class Dim, class Width, class Fun, class SimdFun>
+        struct simd_inner_loop_f {
+            Fun m_fun;
+            SimdFun m_simd_fun;
+            int m_size;
+
+            template <class Ptr, class Strides>
+            void operator()(Ptr &ptr, Strides const &strides) const {
+                using namespace literals;
+                auto &&stride = sid::get_stride<Dim>(strides);
+                int i = 0;
+                for (; i + Width::value <= m_size; i += Width::value) {
+                    m_simd_fun(ptr, strides);
+                    sid::shift(ptr, stride, Width());
+                }
+                for (; i < m_size; ++i) {
+                    m_fun(ptr, strides);
+                    sid::shift(ptr, stride, 1_c);
+                }
+                sid::shift(ptr, stride, -m_size);
+            }
+        };
+
+        template <class BlockSizes, class Sizes, class Dims = get_keys<Sizes>>
+        struct blocking;
+
+        template <class BlockSizes, class Sizes, template <class...> class L, class... Dims>
+        struct blocking<BlockSizes, Sizes, L<Dims...>> {
+            static constexpr std::size_t ndims = sizeof...(Dims);
+
+            std::array<int, ndims> m_sizes;
+            std::array<int, ndims> m_block_sizes;
+            std::array<int, ndims> m_num_blocks;
+            int m_total_blocks = 1;
+
+            blocking(Sizes const &sizes)
+                : m_sizes{int(at_key<Dims>(sizes))...}, m_block_sizes{block_size<BlockSizes, Dims>(
+                                                             at_key<Dims>(sizes))...} {
+                for (std::size_t d = 0; d != ndims; ++d) {
+                    m_block_sizes[d] = std::max(1, std::min(m_block_sizes[d], m_sizes[d]));
+                    m_num_blocks[d] = m_sizes[d] > 0 ? (m_sizes[d] + m_block_sizes[d] - 1) / m_block_sizes[d] : 0;
+                    m_total_blocks *= m_num_blocks[d];
+                }
+            }
+
+            /*
+             * Calls `fun(begin, size)` for all blocks in parallel, where `begin` and `size` are arrays with the
+             * position and the size of the block.
+             */
+            template <class ThreadPool, class Fun>
+            void for_each_block(Fun const &fun) const {
+                thread_pool::parallel_for_loop(
+                    ThreadPool(),
+                    [&](int block) {
+                        std::array<int, ndims> begin, size;
+                        for (std::size_t d = 0; d != ndims; ++d) {
+                            begin[d] = block % m_num_blocks[d] * m_block_sizes[d];
+                            size[d] = std::min(m_block_sizes[d], m_sizes[d] - begin[d]);
+                            block /= m_num_blocks[d];
+                        }
+                        fun(begin, size);
+                    },
+                    m_total_blocks);
+            }
+        };
+
+        /*
+         * Calls `make_row(n)(ptr, strides)` for all rows of the box of the given `size` that starts at `ptr`, where
+         * `n` is the size of the box along the first dimension, which is the innermost loop.
+         */
+        template <class Dims, std::size_t N, class Ptr, class Strides, class MakeRow>
+        void box_rows(std::array<int, N> const &size, Ptr &ptr, Strides const &strides, MakeRow const &make_row) {
+            auto outer_sizes = tuple_util::apply(
+                [](auto, auto... sizes) {
+                    return meta::rename<hymap::keys, meta::pop_front<Dims>>::make_values(sizes...);
+                },
+                size);
+            common::make_loops<meta::reverse<meta::pop_front<Dims>>>(outer_sizes)(make_row(size[0]))(ptr, strides);
+        }
+
+        // Calls `fun(ptr, strides)` for all points of the box of the given `size` that starts at `ptr`.
+        template <class Dims, std::size_t N, class Ptr, class Strides, class Fun>
+        void box_loops(std::array<int, N> const &size, Ptr &ptr, Strides const &strides, Fun const &fun) {
+            if constexpr (N == 0)
+                fun(ptr, strides);
+            else
+                box_rows<Dims>(size, ptr, strides, [&](int n) {
+                    return inner_loop_f<meta::first<Dims>, Fun const &>{fun, n};
+                });
+        }
+
+        /*
+         * Calls `make_row(n)(ptr, strides)` for all rows of the domain given by `sizes`, block by block (see
+         * box_rows). The pointer is moved incrementally inside of a block and only set up from the origin once per
+         * block.
+         */
+        template <class ThreadPool, class BlockSizes, class Sizes, class PtrHolder, class Strides, class MakeRow>
+        void blocked_rows(
+            Sizes const &sizes, PtrHolder const &ptr_holder, Strides const &strides, MakeRow const &make_row) {
+            using dims_t = get_keys<Sizes>;
+            using keys_t = meta::rename<hymap::keys, dims_t>;
+            blocking<BlockSizes, Sizes>(sizes).template for_each_block<ThreadPool>(
+                [&](auto const &begin, auto const &size) {
+                    auto ptr = ptr_holder();
+                    tuple_util::apply(
+                        [&](auto... indices) { sid::multi_shift(ptr, strides, keys_t::make_values(indices...)); },
+                        begin);
+                    box_rows<dims_t>(size, ptr, strides, make_row);
+                });
+        }
+
+        // Calls `fun(ptr, strides)` for all points of the domain given by `sizes`, block by block.
+        template <class ThreadPool, class BlockSizes, class Sizes, class PtrHolder, class Strides, class Fun>
+        void blocked_loops(Sizes const &sizes, PtrHolder const &ptr_holder, Strides const &strides, Fun const &fun) {
+            if constexpr (meta::is_empty<get_keys<Sizes>>::value) {
+                auto ptr = ptr_holder();
+                fun(ptr, strides);
+            } else {
+                blocked_rows<ThreadPool, BlockSizes>(sizes, ptr_holder, strides, [&](int n) {
+                    return inner_loop_f<meta::first<get_keys<Sizes>>, Fun const &>{fun, n};
+                });
+            }
+        }
+
+        template <class BlockSizes,
+            class ThreadPool,
+            class SimdWidth,
+            class InnerDim,
+            class Sizes,
+            class StencilStage,
+            class MakeIterator,
+            class Composite>
+        void apply_stencil_stage(cpu_blocked<BlockSizes, ThreadPool, SimdWidth, InnerDim>,
+            Sizes const &sizes,
+            StencilStage,
+            MakeIterator &&make_iterator,
+            Composite &&composite) {
+            auto ptr_holder = sid::get_origin(std::forward<Composite>(composite));
+            auto strides = sid::get_strides(std::forward<Composite>(composite));
+            blocked_loops<ThreadPool, BlockSizes>(inner_dim_first<InnerDim>(sizes),
+                ptr_holder,
+                strides,
+                [make_iterator = make_iterator()](
+                    auto &ptr, auto const &strides) { StencilStage()(make_iterator, ptr, strides); });
+        }
+
+        template <class BlockSizes,
+            class ThreadPool,
+            class SimdWidth,
+            class InnerDim,
+            class Sizes,
+            class ColumnStage,
+            class MakeIterator,
+            class Composite,
+            class Vertical,
+            class Seed>
+        void apply_column_stage(cpu_blocked<BlockSizes, ThreadPool, SimdWidth, InnerDim>,
+            Sizes const &sizes,
+            ColumnStage,
+            MakeIterator &&make_iterator,
+            Composite &&composite,
+            Vertical,
+            Seed seed) {
+            auto ptr_holder = sid::get_origin(std::forward<Composite>(composite));
+            auto strides = sid::get_strides(std::forward<Composite>(composite));
+            int v_size = at_key<Vertical>(sizes);
+            auto h_sizes = inner_dim_first<InnerDim>(hymap::canonicalize_and_remove_key<Vertical>(sizes));
+            auto column = [v_size, make_iterator = make_iterator(), seed](auto &ptr, auto const &strides) {
+                ColumnStage()(seed, v_size, make_iterator, ptr, strides);
+            };
+            using h_dims_t = get_keys<decltype(h_sizes)>;
+            if constexpr (SimdWidth::value > 1 && !meta::is_empty<h_dims_t>::value) {
+                using lane_dim_t = meta::first<h_dims_t>;
+                auto simd_column = [v_size, make_iterator = make_iterator(), seed = std::move(seed)](
+                                       auto &ptr, auto const &strides) {
+                    simd_column_stage<lane_dim_t, SimdWidth::value, ColumnStage>()(
+                        seed, v_size, make_iterator, ptr, strides);
+                };
+                blocked_rows<ThreadPool, BlockSizes>(h_sizes, ptr_holder, strides, [&](int n) {
+                    return simd_inner_loop_f<lane_dim_t,
+                        SimdWidth,
+                        decltype(column) const &,
+                        decltype(simd_column) const &>{column, simd_column, n};
+                });
+            } else {
+                blocked_loops<ThreadPool, BlockSizes>(h_sizes, ptr_holder, strides, column);
+            }
+        }
+
+        struct make_allocation_f {
+            auto operator()(std::size_t size) const {
+                return std::unique_ptr<void, GT_INTEGRAL_CONSTANT_FROM_VALUE(&hugepage_free)>(hugepage_alloc(size));
+            }
+        };
+
+        struct thread_dim {};
+
+        template <class Extents>
+        struct block_tmp_strides_kind {};
+
+        template <class Extents, class Dims>
+        struct extents_arrays;
+
+        template <class Extents, template <class...> class L, class... Dims>
+        struct extents_arrays<Extents, L<Dims...>> {
+            static constexpr std::array<int, sizeof...(Dims)> lower = {
+                int(extent_at<Extents, Dims>::lower_t::value)...};
+            static constexpr std::array<int, sizeof...(Dims)> size = {int(extent_at<Extents, Dims>::size_t::value)...};
+        };
+
+        /*
+         * Buffers for a local temporary: one per thread, each covering a block extended by the compute extents of the
+         * temporary. The strides along `sid::blocked_dim<Dim>` are the same as along `Dim`; shifting by minus the block
+         * start along them maps the block start to the start of the block in the buffer.
+         */
+        template <class T, class Extents, template <class...> class L, class... Dims, class Allocator, std::size_t N>
+        auto make_block_tmp(L<Dims...>, Allocator &alloc, std::array<int, N> const &block_sizes, int num_threads) {
+            using arrays_t = extents_arrays<Extents, L<Dims...>>;
+            std::array<int, N> strides;
+            int size = 1;
+            int offset = 0;
+            for (std::size_t d = 0; d != N; ++d) {
+                strides[d] = size;
+                offset -= arrays_t::lower[d] * size;
+                size *= block_sizes[d] + arrays_t::size[d];
+            }
+            return sid::synthetic()
+                .set<sid::property::origin>(allocate(alloc, meta::lazy::id<T>(), size * num_threads) + offset)
+                .template set<sid::property::strides>(tuple_util::apply(
+                    [&](auto, auto... strides) {
+                        return hymap::keys<Dims..., sid::blocked_dim<Dims>..., thread_dim>::make_values(
+                            integral_constant<int, 1>(), strides..., integral_constant<int, 1>(), strides..., size);
+                    },
+                    strides))
+                .template set<sid::property::strides_kind, block_tmp_strides_kind<Extents>>()
+                .template set<sid::property::ptr_diff, int>();
+        }
+
+        /*
+         * Executes all fused stages block by block: within a block, a fused stage is applied on the block extended by
+         * its compute extents before the next one starts, and the local temporaries only live in per-thread buffers
+         * of the size of an extended block.
+         */
+        template <class BlockSizes,
+            class ThreadPool,
+            class SimdWidth,
+            class InnerDim,
+            class Sizes,
+            class FusedStages,
+            class MakeIterator,
+            class Sids>
+        void apply_fused_stencil_stages(cpu_blocked<BlockSizes, ThreadPool, SimdWidth, InnerDim>,
+            Sizes const &domain_sizes,
+            FusedStages,
+            MakeIterator const &make_iterator,
+            Sids &&sids) {
+            auto sizes = inner_dim_first<InnerDim>(domain_sizes);
+            using sizes_t = decltype(sizes);
+            using dims_t = get_keys<sizes_t>;
+            using keys_t = meta::rename<hymap::keys, dims_t>;
+            using blocked_keys_t = meta::rename<hymap::keys, meta::transform<sid::blocked_dim, dims_t>>;
+            constexpr std::size_t ndims = meta::length<dims_t>::value;
+            using indices_t = meta::iseq_to_list<std::make_integer_sequence<int, std::tuple_size_v<std::decay_t<Sids>>>,
+                std::tuple,
+                integral_constant>;
+            using composite_keys_t = meta::rename<sid::composite::keys, meta::rename<meta::list, indices_t>>;
+
+            blocking<BlockSizes, sizes_t> blocks(sizes);
+            auto alloc = sid::cached_allocator<make_allocation_f>();
+            int num_threads = thread_pool::get_max_threads(ThreadPool());
+            auto composite = tuple_util::convert_to<composite_keys_t::template values>(tuple_util::transform(
+                [&](auto &&sid, auto index) {
+                    using sid_t = std::decay_t<decltype(sid)>;
+                    if constexpr (is_local_tmp<sid_t>::value) {
+                        return make_block_tmp<typename sid_t::type, local_tmp_extents<FusedStages, decltype(index)>>(
+                            dims_t(), alloc, blocks.m_block_sizes, num_threads);
+                    } else {
+                        return sid_t(std::forward<decltype(sid)>(sid));
+                    }
+                },
+                std::forward<Sids>(sids),
+                indices_t()));
+            auto ptr_holder = sid::get_origin(composite);
+            auto strides = sid::get_strides(composite);
+            auto iterator_maker = make_iterator();
+
+            blocks.template for_each_block<ThreadPool>([&](auto const &begin, auto const &size) {
+                int thread = thread_pool::get_thread_num(ThreadPool());
+                tuple_util::for_each(
+                    [&](auto stage) {
+                        using arrays_t = extents_arrays<typename decltype(stage)::extents_t, dims_t>;
+                        std::array<int, ndims> stage_begin, stage_size;
+                        for (std::size_t d = 0; d != ndims; ++d) {
+                            stage_begin[d] = begin[d] + arrays_t::lower[d];
+                            stage_size[d] = size[d] + arrays_t::size[d];
+                        }
+                        auto ptr = ptr_holder();
+                        tuple_util::apply(
+                            [&](auto... indices) { sid::multi_shift(ptr, strides, keys_t::make_values(indices...)); },
+                            stage_begin);
+                        tuple_util::apply(
+                            [&](auto... indices) {
+                                sid::multi_shift(ptr, strides, blocked_keys_t::make_values(-indices...));
+                            },
+                            begin);
+                        sid::shift(ptr, sid::get_stride<thread_dim>(strides), thread);
+                        box_loops<dims_t>(stage_size, ptr, strides, [&](auto &ptr, auto const &strides) {
+                            decltype(stage)()(iterator_maker, ptr, strides);
+                        });
+                    },
+                    meta::rename<std::tuple, FusedStages>());
+            });
+        }
+
+        // temporaries are not initialized, so their pages are first touched by the threads that compute them
+        template <class BlockSizes, class ThreadPool, class SimdWidth, class InnerDim>
+        auto tmp_allocator(cpu_blocked<BlockSizes, ThreadPool, SimdWidth, InnerDim> be) {
+            return std::make_tuple(be, sid::cached_allocator<make_allocation_f>());
+        }
+
+        template <class BlockSizes,
+            class ThreadPool,
+            class SimdWidth,
+            class InnerDim,
+            class Allocator,
+            class Sizes,
+            class T>
+        auto allocate_global_tmp(std::tuple<cpu_blocked<BlockSizes, ThreadPool, SimdWidth, InnerDim>, Allocator> &alloc,
+            Sizes const &sizes,
+            data_type<T>) {
+            return sid::make_contiguous<T, int_t, sid::unknown_kind>(
+                std::get<1>(alloc), inner_dim_first<InnerDim>(sizes));
+        }
+    } // namespace cpu_blocked_impl_
+
+    using cpu_blocked_impl_::cpu_blocked;
+
+    using cpu_blocked_impl_::apply_column_stage;
+    using cpu_blocked_impl_::apply_fused_stencil_stages;
+    using cpu_blocked_impl_::apply_stencil_stage;
+
+    using cpu_blocked_impl_::allocate_global_tmp;
+    using cpu_blocked_impl_::tmp_allocator;
+} // namespace gridtools::fn::backend
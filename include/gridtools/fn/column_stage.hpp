@@ -42,11 +42,26 @@ namespace gridtools::fn {
         using fwd = base<false>;
         using bwd = base<true>;
 
+        struct store_f {
+            template <class Out, class Ptr, class Strides, class Value>
+            GT_FUNCTION void operator()(Out, Ptr const &ptr, Strides const &, Value &&value) const {
+                *host_device::at_key<Out>(ptr) = std::forward<Value>(value);
+            }
+        };
+
         template <class Vertical, class ScanOrFold, int Out, int... Ins>
         struct column_stage {
-            template <class Seed, class MakeIterator, class Ptr, class Strides>
-            GT_FUNCTION auto operator()(
-                Seed seed, std::size_t size, MakeIterator &&make_iterator, Ptr ptr, Strides const &strides) const {
+            /*
+             * Evaluates the column at `ptr`. The results of scan passes are written with `store(out, ptr, strides,
+             * value)`, where `out` is the `integral_constant` of the output argument.
+             */
+            template <class Seed, class MakeIterator, class Store, class Ptr, class Strides>
+            static GT_FUNCTION auto apply(Seed seed,
+                std::size_t size,
+                MakeIterator &&make_iterator,
+                Store const &store,
+                Ptr ptr,
+                Strides const &strides) {
                 constexpr std::size_t prologue_size = std::tuple_size_v<decltype(ScanOrFold::prologue())>;
                 constexpr std::size_t epilogue_size = std::tuple_size_v<decltype(ScanOrFold::epilogue())>;
                 GT_NVCC_DIAG_PUSH_SUPPRESS(186) // pointless comparison of unsigned with 0
@@ -60,7 +75,7 @@ namespace gridtools::fn {
                         // scan
                         auto res =
                             pass.m_f(std::move(acc), make_iterator(integral_constant<int, Ins>(), ptr, strides)...);
-                        *host_device::at_key<integral_constant<int, Out>>(ptr) = pass.m_p(res);
+                        store(integral_constant<int, Out>(), ptr, strides, pass.m_p(res));
                         inc();
                         return res;
                     } else {
@@ -81,6 +96,17 @@ namespace gridtools::fn {
                     acc = next(std::move(acc), ScanOrFold::body());
                 return tuple_util::host_device::fold(next, std::move(acc), ScanOrFold::epilogue());
             }
+
+            template <class Seed, class MakeIterator, class Ptr, class Strides>
+            GT_FUNCTION auto operator()(
+                Seed seed, std::size_t size, MakeIterator &&make_iterator, Ptr ptr, Strides const &strides) const {
+                return apply(std::move(seed),
+                    size,
+                    std::forward<MakeIterator>(make_iterator),
+                    store_f(),
+                    std::move(ptr),
+                    strides);
+            }
         };
 
         template <class... ColumnStages>
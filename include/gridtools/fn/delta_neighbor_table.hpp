@@ -0,0 +1,167 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * A compressed neighbor table for CPU backends.
+ *
+ * On meshes that are numbered with locality in mind (see fn/renumbering.hpp), the index of a neighbor is close to the
+ * index of the source location scaled by the ratio of the numbers of locations of the two types. The table stores
+ * the difference to this prediction as a 16 bit integer; neighbors that do not fit (outliers) are stored with their
+ * full index in a sorted side table. Missing neighbors (-1) have their own marker.
+ *
+ * `neighbor_table_neighbor` decodes a single neighbor, hence the unstructured iterators only decode the neighbors
+ * that are accessed. When the first neighbor of some location is decoded, the deltas of the next location are
+ * prefetched.
+ *
+ * The table owns its data in host memory and is cheap to copy.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "../common/array.hpp"
+#include "../common/integral_constant.hpp"
+#include "./neighbor_table.hpp"
+
+namespace gridtools::fn::delta_neighbor_table {
+    namespace delta_neighbor_table_impl_ {
+        using delta_t = std::int16_t;
+
+        // marks the neighbors that are stored in the side table
+        constexpr delta_t outlier = std::numeric_limits<delta_t>::min();
+        // marks missing neighbors
+        constexpr delta_t missing = outlier + 1;
+
+        // the prediction is `index * scale >> scale_shift`
+        constexpr int scale_shift = 16;
+
+        struct data {
+            std::vector<delta_t> m_deltas;
+            std::vector<std::int64_t> m_outlier_positions;
+            std::vector<int> m_outlier_values;
+        };
+
+        template <std::size_t MaxNumNeighbors>
+        struct delta_neighbor_table {
+            std::shared_ptr<data const> m_data;
+            delta_t const *m_deltas;
+            std::int64_t const *m_outlier_positions;
+            int const *m_outlier_values;
+            std::size_t m_num_outliers;
+            std::int64_t m_scale;
+            std::int64_t m_size;
+
+            int predict(int index) const { return int(index * m_scale >> scale_shift); }
+
+            int decode(int index, std::size_t offset) const {
+                std::int64_t pos = index * std::int64_t(MaxNumNeighbors) + offset;
+                delta_t delta = m_deltas[pos];
+                if (delta > missing)
+                    return predict(index) + delta;
+                return decode_special(delta, pos);
+            }
+
+            int decode_special(delta_t delta, std::int64_t pos) const {
+                if (delta == missing)
+                    return -1;
+                auto it = std::lower_bound(m_outlier_positions, m_outlier_positions + m_num_outliers, pos);
+                return m_outlier_values[it - m_outlier_positions];
+            }
+
+            void prefetch_next(int index) const {
+#ifdef __GNUC__
+                if (index + 1 < m_size)
+                    __builtin_prefetch(m_deltas + (index + 1) * std::int64_t(MaxNumNeighbors));
+#endif
+            }
+        };
+
+        template <std::size_t MaxNumNeighbors, int I>
+        int neighbor_table_neighbor(
+            delta_neighbor_table<MaxNumNeighbors> const &table, int index, integral_constant<int, I>) {
+            static_assert(I >= 0 && I < (int)MaxNumNeighbors);
+            if constexpr (I == 0)
+                table.prefetch_next(index);
+            return table.decode(index, I);
+        }
+
+        template <std::size_t MaxNumNeighbors>
+        array<int, MaxNumNeighbors> neighbor_table_neighbors(
+            delta_neighbor_table<MaxNumNeighbors> const &table, int index) {
+            table.prefetch_next(index);
+            array<int, MaxNumNeighbors> res;
+            for (std::size_t i = 0; i != MaxNumNeighbors; ++i)
+                res[i] = table.decode(index, i);
+            return res;
+        }
+
+        /*
+         * Compresses the neighbor table given as a host view (with `lengths()` and `operator()(index, neighbor)`),
+         * where the neighbors are locations of a type with `num_targets` locations. Throws `std::domain_error` if the
+         * table has more than `MaxNumNeighbors` neighbors per location.
+         */
+        template <std::size_t MaxNumNeighbors, class View>
+        delta_neighbor_table<MaxNumNeighbors> make_delta_neighbor_table(View const &view, int num_targets) {
+            int size = view.lengths()[0];
+            int max_neighbors = view.lengths()[1];
+            if (max_neighbors > (int)MaxNumNeighbors)
+                throw std::domain_error("neighbor table has " + std::to_string(max_neighbors) +
+                                        " neighbors per location, at most " + std::to_string(MaxNumNeighbors) +
+                                        " are supported");
+            std::int64_t scale = size > 0 ? (std::int64_t(num_targets) << scale_shift) / size : 0;
+            auto res = std::make_shared<data>();
+            res->m_deltas.resize(std::size_t(size) * MaxNumNeighbors, 0);
+            for (int i = 0; i != size; ++i) {
+                std::int64_t predicted = i * scale >> scale_shift;
+                for (std::size_t m = 0; m != MaxNumNeighbors; ++m) {
+                    int neighbor = (int)m < max_neighbors ? view(i, m) : -1;
+                    std::int64_t delta = neighbor - predicted;
+                    std::int64_t pos = i * std::int64_t(MaxNumNeighbors) + m;
+                    if (neighbor == -1) {
+                        res->m_deltas[pos] = missing;
+                    } else if (delta > missing && delta <= std::numeric_limits<delta_t>::max()) {
+                        res->m_deltas[pos] = delta_t(delta);
+                    } else {
+                        res->m_deltas[pos] = outlier;
+                        res->m_outlier_positions.push_back(pos);
+                        res->m_outlier_values.push_back(neighbor);
+                    }
+                }
+            }
+            return {res,
+                res->m_deltas.data(),
+                res->m_outlier_positions.data(),
+                res->m_outlier_values.data(),
+                res->m_outlier_positions.size(),
+                scale,
+                size};
+        }
+
+        // the fraction of neighbors that are stored in the side table
+        template <std::size_t MaxNumNeighbors>
+        double outlier_ratio(delta_neighbor_table<MaxNumNeighbors> const &table) {
+            return table.m_size > 0 ? double(table.m_num_outliers) / double(table.m_size * MaxNumNeighbors) : 0;
+        }
+    } // namespace delta_neighbor_table_impl_
+
+    using delta_neighbor_table_impl_::delta_neighbor_table;
+    using delta_neighbor_table_impl_::make_delta_neighbor_table;
+    using delta_neighbor_table_impl_::outlier_ratio;
+} // namespace gridtools::fn::delta_neighbor_table
@@ -16,6 +16,7 @@
 #include "../sid/sid_shift_origin.hpp"
 #include "./column_stage.hpp"
 #include "./run.hpp"
+#include "./stage_fusion.hpp"
 #include "./stencil_stage.hpp"
 
 namespace gridtools::fn {
@@ -36,10 +37,18 @@ namespace gridtools::fn {
             using arg_offset_t = std::integral_constant<int, ArgOffset>;
             using specs_t = Specs;
 
+            template <class Arg>
+            auto shift_arg(Arg &&arg) const {
+                if constexpr (is_local_tmp<std::decay_t<Arg>>::value)
+                    return std::decay_t<Arg>();
+                else
+                    return sid::shift_sid_origin(std::forward<Arg>(arg), m_offsets);
+            }
+
             template <class Arg>
             auto arg(Arg &&arg) && {
-                auto args = tuple_util::deep_copy(
-                    tuple_util::push_back(std::move(m_args), sid::shift_sid_origin(std::forward<Arg>(arg), m_offsets)));
+                auto args =
+                    tuple_util::deep_copy(tuple_util::push_back(std::move(m_args), shift_arg(std::forward<Arg>(arg))));
                 return executor_data<Backend, ArgOffset, Sizes, Offsets, MakeIterator, decltype(args), Specs>{
                     std::move(m_backend),
                     std::move(m_sizes),
@@ -60,6 +69,10 @@ namespace gridtools::fn {
             }
         };
 
+        /*
+         * The arguments may contain local temporaries (`local_tmp<T>()`) that only live during `execute`. The stages
+         * that write and read them may be fused by the backend, see `stage_fusion.hpp` for the requirements.
+         */
         template <class Data>
         struct stencil_executor {
             Data m_data;
@@ -109,6 +109,28 @@ namespace gridtools {
             struct merge_extents<meta::list<Dim, extent<Dim, L, U>>...> {
                 using type = meta::list<Dim, extent<Dim, std::min({L...}), std::max({U...})>>;
             };
+
+            template <class...>
+            struct add_extents;
+
+            template <class Dim, std::ptrdiff_t... L, std::ptrdiff_t... U>
+            struct add_extents<meta::list<Dim, extent<Dim, L, U>>...> {
+                using type = meta::list<Dim, extent<Dim, (L + ...), (U + ...)>>;
+            };
+
+            template <class... Extents>
+            using make_sum_extents = meta::rename<extents,
+                meta::transform<meta::second,
+                    meta::mp_make<meta::force<add_extents>::template apply,
+                        meta::list<meta::list<typename Extents::dim_t, Extents>...>>>>;
+
+            template <class Extents>
+            struct to_map;
+
+            template <class... Ts>
+            struct to_map<extents<Ts...>> {
+                using type = meta::list<meta::list<typename Ts::dim_t, Ts>...>;
+            };
         } // namespace extent_impl_
 
         // T any number of individual `extent`s and produce the normalized `extents`.
@@ -123,5 +145,15 @@ namespace gridtools {
         template <class... Extentss>
         using enclosing_extents = meta::rename<make_extents, meta::concat<meta::rename<meta::list, Extentss>...>>;
 
+        // Add several `extents`s dimension-wise, i.e. the extents of a composition of shifts
+        template <class... Extentss>
+        using sum_extents =
+            meta::rename<extent_impl_::make_sum_extents, meta::concat<meta::rename<meta::list, Extentss>...>>;
+
+        // The `extent` of `Extents` along `Dim`; zero if `Extents` has no extent along `Dim`
+        template <class Extents, class Dim>
+        using extent_at = meta::second<
+            meta::mp_find<typename extent_impl_::to_map<Extents>::type, Dim, meta::list<Dim, extent<Dim, 0, 0>>>>;
+
     } // namespace fn
 } // namespace gridtools
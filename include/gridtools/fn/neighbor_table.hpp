@@ -11,6 +11,8 @@
 
 #include <type_traits>
 
+#include "../common/defs.hpp"
+#include "../common/integral_constant.hpp"
 #include "../common/tuple_util.hpp"
 #include "../meta/logical.hpp"
 
@@ -27,6 +29,11 @@
  *
  *   Pure functional behavior without side-effects is expected from the provided function.
  *
+ *   Optionally, a single neighbor can be provided by
+ *     `int neighbor_table_neighbor(T const&, int index, integral_constant<int, I>);`
+ *   which should return the same as `get<I>(neighbor_table_neighbors(table, index))`. Tables that store their
+ *   neighbors in compressed form can use it to only decode the requested neighbor.
+ *
  *   Compile-time API
  *   ================
  *
@@ -39,6 +46,10 @@
  *
  *   `Neighbors neighbor_table::neighbors(NeighborTable const&, int);`
  *
+ *   The neighbor at offset `I`, using `neighbor_table_neighbor` if available:
+ *
+ *   `int neighbor_table::neighbor<I>(NeighborTable const&, int);`
+ *
  *   Default Implementation
  *   ======================
  *
@@ -65,6 +76,23 @@ namespace gridtools::fn::neighbor_table {
             return neighbor_table_neighbors(nt, index);
         }
 
+        template <int I, class NeighborTable, class = void>
+        struct has_neighbor : std::false_type {};
+
+        template <int I, class NeighborTable>
+        struct has_neighbor<I,
+            NeighborTable,
+            std::void_t<decltype(neighbor_table_neighbor(
+                std::declval<NeighborTable const &>(), 0, integral_constant<int, I>()))>> : std::true_type {};
+
+        template <int I, class NeighborTable>
+        GT_FUNCTION constexpr auto neighbor(NeighborTable const &nt, int index) {
+            if constexpr (has_neighbor<I, NeighborTable>::value)
+                return neighbor_table_neighbor(nt, index, integral_constant<int, I>());
+            else
+                return tuple_util::host_device::get<I>(neighbors(nt, index));
+        }
+
         template <class T>
         using neighbor_list_type = std::remove_cv_t<std::remove_reference_t<
             decltype(::gridtools::fn::neighbor_table::neighbor_table_impl_::neighbors(std::declval<T const &>(), 0))>>;
@@ -79,6 +107,7 @@ namespace gridtools::fn::neighbor_table {
     } // namespace neighbor_table_impl_
 
     using neighbor_table_impl_::is_neighbor_table;
+    using neighbor_table_impl_::neighbor;
     using neighbor_table_impl_::neighbors;
 
 } // namespace gridtools::fn::neighbor_table
@@ -0,0 +1,245 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * Host utilities to renumber the locations of an unstructured mesh for better memory locality.
+ *
+ * The unstructured iterators access neighbors through the neighbor tables, so the cache behavior of a stencil depends
+ * on how close the indices of neighboring locations are. A `permutation` maps the old (e.g. generator provided)
+ * indices of a location type to new ones:
+ *  - `reverse_cuthill_mckee(adjacency)` computes a bandwidth reducing order from the connectivity of a location type
+ *    to itself, `make_adjacency(a2b, b2a)` builds it from two neighbor tables (e.g. vertex to vertex from v2e and e2v);
+ *  - `induced_permutation(b2a, a_perm)` orders another location type along an already renumbered one (e.g. the edges
+ *    by their vertices);
+ *  - `permute_table` and `permute_field` apply the permutations to neighbor tables and fields;
+ *  - `inverse(perm)` gives the reverse mapping, e.g. to write the results in the original order.
+ *
+ * Tables and fields are passed as host views of data stores (anything with `lengths()` and a call operator). The
+ * first dimension of tables and fields is the location index, the second dimension of tables the neighbor index,
+ * where missing neighbors are encoded as -1.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "../common/array.hpp"
+
+namespace gridtools::fn::renumbering {
+    namespace renumbering_impl_ {
+        class permutation {
+            std::vector<int> m_new_to_old;
+            std::vector<int> m_old_to_new;
+
+          public:
+            permutation() = default;
+
+            // `new_to_old[i]` is the old index of the location with the new index `i`
+            explicit permutation(std::vector<int> new_to_old)
+                : m_new_to_old(std::move(new_to_old)), m_old_to_new(m_new_to_old.size(), -1) {
+                for (std::size_t i = 0; i != m_new_to_old.size(); ++i) {
+                    assert(m_new_to_old[i] >= 0 && m_new_to_old[i] < (int)size());
+                    assert(m_old_to_new[m_new_to_old[i]] == -1);
+                    m_old_to_new[m_new_to_old[i]] = i;
+                }
+            }
+
+            int size() const { return m_new_to_old.size(); }
+            int new_to_old(int i) const { return m_new_to_old[i]; }
+            int old_to_new(int i) const { return m_old_to_new[i]; }
+        };
+
+        inline permutation identity_permutation(int size) {
+            std::vector<int> order(size);
+            std::iota(order.begin(), order.end(), 0);
+            return permutation(std::move(order));
+        }
+
+        inline permutation inverse(permutation const &perm) {
+            std::vector<int> order(perm.size());
+            for (int i = 0; i != perm.size(); ++i)
+                order[i] = perm.old_to_new(i);
+            return permutation(std::move(order));
+        }
+
+        // renumbers with `first` and then with `second`
+        inline permutation compose(permutation const &first, permutation const &second) {
+            assert(first.size() == second.size());
+            std::vector<int> order(first.size());
+            for (int i = 0; i != first.size(); ++i)
+                order[i] = first.new_to_old(second.new_to_old(i));
+            return permutation(std::move(order));
+        }
+
+        // The neighbors of each location of one type in compressed row format
+        struct adjacency {
+            std::vector<int> m_offsets = {0};
+            std::vector<int> m_neighbors;
+
+            int size() const { return m_offsets.size() - 1; }
+            int degree(int i) const { return m_offsets[i + 1] - m_offsets[i]; }
+            int const *begin(int i) const { return m_neighbors.data() + m_offsets[i]; }
+            int const *end(int i) const { return m_neighbors.data() + m_offsets[i + 1]; }
+        };
+
+        /*
+         * The adjacency of the locations of type A to each other, where two locations are adjacent if they share a
+         * neighbor of type B.
+         */
+        template <class A2B, class B2A>
+        adjacency make_adjacency(A2B const &a2b, B2A const &b2a) {
+            int n = a2b.lengths()[0];
+            int max_a2b = a2b.lengths()[1];
+            int max_b2a = b2a.lengths()[1];
+            adjacency res;
+            std::vector<int> neighbors;
+            for (int i = 0; i != n; ++i) {
+                neighbors.clear();
+                for (int m = 0; m != max_a2b; ++m) {
+                    int b = a2b(i, m);
+                    if (b < 0)
+                        continue;
+                    for (int l = 0; l != max_b2a; ++l) {
+                        int a = b2a(b, l);
+                        if (a >= 0 && a != i)
+                            neighbors.push_back(a);
+                    }
+                }
+                std::sort(neighbors.begin(), neighbors.end());
+                neighbors.erase(std::unique(neighbors.begin(), neighbors.end()), neighbors.end());
+                res.m_neighbors.insert(res.m_neighbors.end(), neighbors.begin(), neighbors.end());
+                res.m_offsets.push_back(res.m_neighbors.size());
+            }
+            return res;
+        }
+
+        /*
+         * Reverse Cuthill-McKee ordering: a breadth first traversal that starts at a location of minimal degree and
+         * visits the neighbors in the order of increasing degree, reversed. Neighboring locations get close indices.
+         */
+        inline permutation reverse_cuthill_mckee(adjacency const &adj) {
+            int n = adj.size();
+            std::vector<int> by_degree(n);
+            std::iota(by_degree.begin(), by_degree.end(), 0);
+            std::stable_sort(
+                by_degree.begin(), by_degree.end(), [&](int l, int r) { return adj.degree(l) < adj.degree(r); });
+            std::vector<bool> visited(n, false);
+            std::vector<int> order;
+            order.reserve(n);
+            std::vector<int> neighbors;
+            for (int start : by_degree) {
+                // one breadth first traversal per connected component
+                if (visited[start])
+                    continue;
+                visited[start] = true;
+                std::size_t head = order.size();
+                order.push_back(start);
+                for (; head != order.size(); ++head) {
+                    int i = order[head];
+                    neighbors.clear();
+                    for (auto it = adj.begin(i); it != adj.end(i); ++it)
+                        if (!visited[*it])
+                            neighbors.push_back(*it);
+                    std::stable_sort(neighbors.begin(), neighbors.end(), [&](int l, int r) {
+                        return adj.degree(l) < adj.degree(r);
+                    });
+                    for (int j : neighbors) {
+                        visited[j] = true;
+                        order.push_back(j);
+                    }
+                }
+            }
+            std::reverse(order.begin(), order.end());
+            return permutation(std::move(order));
+        }
+
+        /*
+         * Orders the locations of type B by the smallest new index of their neighbors of type A, ties are broken by
+         * the old index.
+         */
+        template <class B2A>
+        permutation induced_permutation(B2A const &b2a, permutation const &a_perm) {
+            int n = b2a.lengths()[0];
+            int max_b2a = b2a.lengths()[1];
+            std::vector<int> keys(n, a_perm.size());
+            for (int i = 0; i != n; ++i)
+                for (int l = 0; l != max_b2a; ++l) {
+                    int a = b2a(i, l);
+                    if (a >= 0)
+                        keys[i] = std::min(keys[i], a_perm.old_to_new(a));
+                }
+            std::vector<int> order(n);
+            std::iota(order.begin(), order.end(), 0);
+            std::stable_sort(order.begin(), order.end(), [&](int l, int r) { return keys[l] < keys[r]; });
+            return permutation(std::move(order));
+        }
+
+        /*
+         * `dst(i, m) = values.old_to_new(src(rows.new_to_old(i), m))`, where `rows` renumbers the locations of the
+         * table and `values` the locations of the neighbors.
+         */
+        template <class Src, class Dst>
+        void permute_table(permutation const &rows, permutation const &values, Src const &src, Dst const &dst) {
+            int n = src.lengths()[0];
+            int max_neighbors = src.lengths()[1];
+            assert(rows.size() == n);
+            assert((int)dst.lengths()[0] == n && (int)dst.lengths()[1] == max_neighbors);
+            for (int i = 0; i != n; ++i)
+                for (int m = 0; m != max_neighbors; ++m) {
+                    int neighbor = src(rows.new_to_old(i), m);
+                    dst(i, m) = neighbor < 0 ? neighbor : values.old_to_new(neighbor);
+                }
+        }
+
+        // `dst(i, ...) = src(perm.new_to_old(i), ...)`
+        template <class Src, class Dst>
+        void permute_field(permutation const &perm, Src const &src, Dst const &dst) {
+            auto lengths = src.lengths();
+            constexpr std::size_t ndims = std::tuple_size_v<decltype(lengths)>;
+            assert((int)lengths[0] == perm.size());
+            for (std::size_t d = 0; d != ndims; ++d)
+                if (lengths[d] == 0)
+                    return;
+            array<int, ndims> index = {};
+            while (true) {
+                auto src_index = index;
+                src_index[0] = perm.new_to_old(index[0]);
+                dst(index) = src(src_index);
+                std::size_t d = 0;
+                for (; d != ndims; ++d) {
+                    if (++index[d] != (int)lengths[d])
+                        break;
+                    index[d] = 0;
+                }
+                if (d == ndims)
+                    return;
+            }
+        }
+    } // namespace renumbering_impl_
+
+    using renumbering_impl_::adjacency;
+    using renumbering_impl_::compose;
+    using renumbering_impl_::identity_permutation;
+    using renumbering_impl_::induced_permutation;
+    using renumbering_impl_::inverse;
+    using renumbering_impl_::make_adjacency;
+    using renumbering_impl_::permutation;
+    using renumbering_impl_::permute_field;
+    using renumbering_impl_::permute_table;
+    using renumbering_impl_::reverse_cuthill_mckee;
+} // namespace gridtools::fn::renumbering
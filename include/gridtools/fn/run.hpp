@@ -9,9 +9,14 @@
  */
 #pragma once
 
+#include "../common/int_vector.hpp"
 #include "../common/tuple_util.hpp"
 #include "../meta.hpp"
 #include "../sid/composite.hpp"
+#include "../sid/sid_shift_origin.hpp"
+#include "./backend/common.hpp"
+#include "./extents.hpp"
+#include "./stage_fusion.hpp"
 #include "./stencil_stage.hpp"
 
 namespace gridtools::fn {
@@ -24,13 +29,59 @@ namespace gridtools::fn {
             return tuple_util::convert_to<keys_t::template values>(std::forward<Sids>(sids));
         }
 
+        /*
+         * Default execution of fused stages: the local temporaries are allocated as global temporaries that cover
+         * their compute extents and the fused stages are applied one after the other on their extended domains.
+         * Backends can provide a more efficient overload of `apply_fused_stencil_stages`.
+         */
+        template <class Backend, class FusedStages, class MakeIterator, class Domain, class Sids>
+        void apply_fused_stencil_stages(
+            Backend const &backend, Domain const &domain, FusedStages, MakeIterator const &make_iterator, Sids &&sids) {
+            using namespace int_vector::arithmetic;
+            using indices_t = meta::iseq_to_list<std::make_integer_sequence<int, std::tuple_size_v<std::decay_t<Sids>>>,
+                std::tuple,
+                integral_constant>;
+            auto alloc = tmp_allocator(backend);
+            auto args = tuple_util::transform(
+                [&](auto &&sid, auto index) {
+                    using sid_t = std::decay_t<decltype(sid)>;
+                    if constexpr (is_local_tmp<sid_t>::value) {
+                        using extents_t = local_tmp_extents<FusedStages, decltype(index)>;
+                        return sid::shift_sid_origin(allocate_global_tmp(alloc,
+                                                         extend_sizes<extents_t>(domain),
+                                                         backend::data_type<typename sid_t::type>()),
+                            -extents_t::offsets());
+                    } else {
+                        return sid_t(std::forward<decltype(sid)>(sid));
+                    }
+                },
+                std::forward<Sids>(sids),
+                indices_t());
+            tuple_util::for_each(
+                [&](auto stage) {
+                    using extents_t = typename decltype(stage)::extents_t;
+                    auto composite = make_composite(tuple_util::transform(
+                        [](auto &sid) { return sid::shift_sid_origin(sid, extents_t::offsets()); }, args));
+                    apply_stencil_stage(
+                        backend, extend_sizes<extents_t>(domain), std::move(stage), make_iterator, composite);
+                },
+                meta::rename<std::tuple, FusedStages>());
+        }
+
         template <class Backend, class StageSpecs, class MakeIterator, class Domain, class Sids>
         void run_stencil_stages(
             Backend const &backend, StageSpecs, MakeIterator const &make_iterator, Domain const &domain, Sids &&sids) {
-            auto composite = make_composite(std::forward<Sids>(sids));
-            tuple_util::for_each(
-                [&](auto stage) { apply_stencil_stage(backend, domain, std::move(stage), make_iterator, composite); },
-                meta::rename<std::tuple, StageSpecs>());
+            if constexpr (has_local_tmps<Sids>::value) {
+                apply_fused_stencil_stages(
+                    backend, domain, fused_stages<StageSpecs, Sids>(), make_iterator, std::forward<Sids>(sids));
+            } else {
+                auto composite = make_composite(std::forward<Sids>(sids));
+                tuple_util::for_each(
+                    [&](auto stage) {
+                        apply_stencil_stage(backend, domain, std::move(stage), make_iterator, composite);
+                    },
+                    meta::rename<std::tuple, StageSpecs>());
+            }
         }
 
         template <class Backend,
@@ -0,0 +1,240 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * Evaluation of column stages on `Width` neighboring columns in lockstep.
+ *
+ * The vertical recurrence of a scan or a fold can not be vectorized along the vertical, but neighboring columns are
+ * independent. `simd_column_stage<LaneDim, Width, ColumnStage>` evaluates the columns at `ptr`, `ptr + stride`, ...,
+ * `ptr + (Width - 1) * stride`, where `stride` is the stride along `LaneDim`:
+ *  - the accumulator is a `simd_pack` (or a tuple of them if the seed is a tuple), that holds one value per column;
+ *  - the iterators passed to the scan and fold functions hold one iterator per column, `deref` gathers the values
+ *    of all columns into a `simd_pack`;
+ *  - the results of the scan passes are scattered back to the columns.
+ *
+ * The scan and fold functions hence must be generic with respect to their argument types and may only use the
+ * arithmetic operators `+`, `-`, `*` and `/` on the accumulator and on the dereferenced values, which is the case for
+ * the usual vertical solvers. Branching on values and `can_deref` are not supported.
+ *
+ * `LaneDim` should be the contiguous dimension of the fields.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+#include "../common/integral_constant.hpp"
+#include "../common/tuple.hpp"
+#include "../common/tuple_util.hpp"
+#include "../meta.hpp"
+#include "../sid/concept.hpp"
+#include "./column_stage.hpp"
+
+namespace gridtools::fn {
+    namespace simd_column_stage_impl_ {
+        template <class T, int Width>
+        struct simd_pack {
+            T m_values[Width];
+
+            simd_pack() = default;
+
+            // broadcasts the value to all lanes, such that `float_t(0.25)` works if `float_t` is a pack type
+            template <class U, std::enable_if_t<std::is_arithmetic_v<U>, int> = 0>
+            explicit simd_pack(U value) {
+                for (int l = 0; l < Width; ++l)
+                    m_values[l] = T(value);
+            }
+        };
+
+        template <class T>
+        struct is_simd_pack : std::false_type {};
+
+        template <class T, int Width>
+        struct is_simd_pack<simd_pack<T, Width>> : std::true_type {};
+
+        template <class T, int Width, class F>
+        simd_pack<T, Width> elementwise(F const &f) {
+            simd_pack<T, Width> res;
+#pragma omp simd
+            for (int l = 0; l < Width; ++l)
+                res.m_values[l] = f(l);
+            return res;
+        }
+
+        template <class T, int Width>
+        simd_pack<T, Width> operator-(simd_pack<T, Width> const &arg) {
+            return elementwise<T, Width>([&](int l) { return -arg.m_values[l]; });
+        }
+
+#define GT_FN_SIMD_PACK_OPERATOR(op)                                                                                   \
+    template <class T, int Width>                                                                                      \
+    simd_pack<T, Width> operator op(simd_pack<T, Width> const &lhs, simd_pack<T, Width> const &rhs) {                  \
+        return elementwise<T, Width>([&](int l) { return lhs.m_values[l] op rhs.m_values[l]; });                       \
+    }                                                                                                                  \
+    template <class T, int Width, class U, std::enable_if_t<std::is_arithmetic_v<U>, int> = 0>                         \
+    simd_pack<T, Width> operator op(simd_pack<T, Width> const &lhs, U rhs) {                                           \
+        return elementwise<T, Width>([&](int l) { return lhs.m_values[l] op T(rhs); });                                \
+    }                                                                                                                  \
+    template <class T, int Width, class U, std::enable_if_t<std::is_arithmetic_v<U>, int> = 0>                         \
+    simd_pack<T, Width> operator op(U lhs, simd_pack<T, Width> const &rhs) {                                           \
+        return elementwise<T, Width>([&](int l) { return T(lhs) op rhs.m_values[l]; });                                \
+    }
+
+        GT_FN_SIMD_PACK_OPERATOR(+)
+        GT_FN_SIMD_PACK_OPERATOR(-)
+        GT_FN_SIMD_PACK_OPERATOR(*)
+        GT_FN_SIMD_PACK_OPERATOR(/)
+
+#undef GT_FN_SIMD_PACK_OPERATOR
+
+        // the value of the lane `l` of a pack, of a tuple of packs or of a scalar (that is the same for all lanes)
+        template <class T>
+        decltype(auto) get_lane(T const &value, int l) {
+            if constexpr (is_simd_pack<T>::value)
+                return value.m_values[l];
+            else if constexpr (is_tuple_like<T>::value)
+                return tuple_util::transform([l](auto const &elem) { return get_lane(elem, l); }, value);
+            else
+                return value;
+        }
+
+        template <int Width, class T>
+        auto broadcast(T const &value) {
+            if constexpr (is_simd_pack<T>::value)
+                return value;
+            else if constexpr (is_tuple_like<T>::value)
+                return tuple_util::transform([](auto const &elem) { return broadcast<Width>(elem); }, value);
+            else
+                return simd_pack<T, Width>(value);
+        }
+
+        // packs the values of all lanes; tuples of values become tuples of packs
+        template <class T, std::size_t Width>
+        auto gather(std::array<T, Width> const &values) {
+            if constexpr (is_tuple_like<T>::value) {
+                return tuple_util::transform(
+                    [&](auto i) {
+                        using elem_t = std::decay_t<decltype(tuple_util::get<decltype(i)::value>(values[0]))>;
+                        std::array<elem_t, Width> elems;
+                        for (std::size_t l = 0; l != Width; ++l)
+                            elems[l] = tuple_util::get<decltype(i)::value>(values[l]);
+                        return gather(elems);
+                    },
+                    meta::make_indices_for<tuple_util::traits::to_types<T>, tuple>());
+            } else {
+                return elementwise<T, int(Width)>([&](int l) { return values[l]; });
+            }
+        }
+
+        template <class It>
+        decltype(auto) deref_lane(It const &it) {
+            if constexpr (std::is_pointer_v<It>)
+                return *it;
+            else
+                return deref(it);
+        }
+
+        template <class It, int Width>
+        struct lanes_iterator {
+            std::array<It, Width> m_lanes;
+
+            template <int... Ls>
+            auto deref_impl(std::integer_sequence<int, Ls...>) const {
+                using value_t = std::decay_t<decltype(deref_lane(m_lanes[0]))>;
+                return gather(std::array<value_t, Width>{deref_lane(m_lanes[Ls])...});
+            }
+
+            template <class... Offsets, int... Ls>
+            auto shift_impl(std::integer_sequence<int, Ls...>, Offsets... offsets) const {
+                using lane_t = decltype(shift(m_lanes[0], offsets...));
+                return lanes_iterator<lane_t, Width>{{shift(m_lanes[Ls], offsets...)...}};
+            }
+
+            friend auto deref(lanes_iterator const &it) {
+                return it.deref_impl(std::make_integer_sequence<int, Width>());
+            }
+
+            template <class... Offsets>
+            friend auto shift(lanes_iterator const &it, Offsets... offsets) {
+                return it.shift_impl(std::make_integer_sequence<int, Width>(), offsets...);
+            }
+
+            auto operator*() const { return deref(*this); }
+        };
+
+        template <class LaneDim, int Width, class MakeIterator>
+        struct make_lanes_iterator_f {
+            MakeIterator const &m_make_iterator;
+
+            template <class Tag, class Ptr, class Strides, int... Ls>
+            auto impl(std::integer_sequence<int, Ls...>, Tag tag, Ptr const &ptr, Strides const &strides) const {
+                auto const &stride = sid::get_stride<LaneDim>(strides);
+                using lane_t = decltype(m_make_iterator(tag, ptr, strides));
+                return lanes_iterator<lane_t, Width>{{m_make_iterator(tag, sid::shifted(ptr, stride, Ls), strides)...}};
+            }
+
+            template <class Tag, class Ptr, class Strides>
+            auto operator()(Tag tag, Ptr const &ptr, Strides const &strides) const {
+                return impl(std::make_integer_sequence<int, Width>(), tag, ptr, strides);
+            }
+        };
+
+        template <class LaneDim, int Width>
+        struct lanes_store_f {
+            template <class Out, class Ptr, class Strides, class Value>
+            void operator()(Out, Ptr const &ptr, Strides const &strides, Value const &value) const {
+                auto const &out_ptr = at_key<Out>(ptr);
+                auto const &stride = at_key<Out>(sid::get_stride<LaneDim>(strides));
+                for (int l = 0; l != Width; ++l)
+                    *sid::shifted(out_ptr, stride, l) = get_lane(value, l);
+            }
+        };
+
+        template <class LaneDim, int Width, class ColumnStage>
+        struct simd_column_stage;
+
+        template <class LaneDim, int Width, class Vertical, class ScanOrFold, int Out, int... Ins>
+        struct simd_column_stage<LaneDim, Width, column_stage<Vertical, ScanOrFold, Out, Ins...>> {
+            template <class Seed, class MakeIterator, class Ptr, class Strides>
+            auto operator()(
+                Seed const &seed, std::size_t size, MakeIterator const &make_iterator, Ptr ptr, Strides const &strides)
+                const {
+                return column_stage<Vertical, ScanOrFold, Out, Ins...>::apply(broadcast<Width>(seed),
+                    size,
+                    make_lanes_iterator_f<LaneDim, Width, MakeIterator>{make_iterator},
+                    lanes_store_f<LaneDim, Width>(),
+                    std::move(ptr),
+                    strides);
+            }
+        };
+
+        template <class LaneDim, int Width, class... ColumnStages>
+        struct simd_column_stage<LaneDim, Width, merged_column_stage<ColumnStages...>> {
+            template <class Seed, class MakeIterator, class Ptr, class Strides>
+            auto operator()(
+                Seed const &seed, std::size_t size, MakeIterator const &make_iterator, Ptr ptr, Strides const &strides)
+                const {
+                return tuple_util::fold(
+                    [&](auto acc, auto stage) { return stage(std::move(acc), size, make_iterator, ptr, strides); },
+                    broadcast<Width>(seed),
+                    tuple(simd_column_stage<LaneDim, Width, ColumnStages>()...));
+            }
+        };
+    } // namespace simd_column_stage_impl_
+
+    using simd_column_stage_impl_::get_lane;
+    using simd_column_stage_impl_::simd_column_stage;
+    using simd_column_stage_impl_::simd_pack;
+} // namespace gridtools::fn
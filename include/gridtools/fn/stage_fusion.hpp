@@ -0,0 +1,253 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * Fusion of the stencil stages of one executor that communicate through local temporaries.
+ *
+ * A local temporary (`local_tmp<T>`, passed with `.arg(local_tmp<T>())` to a stencil executor) only lives during one
+ * `execute()`. Nobody else can observe it, hence a backend is free to run the stages that produce and consume it
+ * block by block and to keep only the part of the temporary that is needed by the current block. For this, a stage
+ * that writes a local temporary computes it on the domain extended by the extents with which the later stages read
+ * it (its compute extents); this part is recomputed by neighboring blocks.
+ *
+ * The extents with which a stencil reads its arguments are given by a nested type `extents_t` of the stencil, for
+ * example `using extents_t = make_extents<extent<dim::i, -1, 1>, extent<dim::j, -1, 1>>;`. It is required for all
+ * stencils that read a local temporary; a stencil without it reads its arguments only at the current point.
+ *
+ * Consecutive stages with the same compute extents are merged into one `fused_stage`.
+ */
+
+#pragma once
+
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../common/integral_constant.hpp"
+#include "../meta.hpp"
+#include "./extents.hpp"
+#include "./stencil_stage.hpp"
+
+namespace gridtools::fn {
+    template <class T>
+    struct local_tmp {
+        using type = T;
+    };
+
+    namespace stage_fusion_impl_ {
+        template <class>
+        struct is_local_tmp : std::false_type {};
+
+        template <class T>
+        struct is_local_tmp<local_tmp<T>> : std::true_type {};
+
+        template <class Stencil, class = void>
+        struct stencil_extents {
+            using has_extents_t = std::false_type;
+            using type = extents<>;
+        };
+
+        template <class Stencil>
+        struct stencil_extents<Stencil, std::void_t<typename Stencil::extents_t>> {
+            static_assert(is_extents<typename Stencil::extents_t>::value);
+            using has_extents_t = std::true_type;
+            using type = typename Stencil::extents_t;
+        };
+
+        template <class Stage>
+        struct stage_info;
+
+        template <class Stencil, int Out, int... Ins>
+        struct stage_info<stencil_stage<Stencil, Out, Ins...>> : stencil_extents<Stencil> {
+            using out_t = integral_constant<int, Out>;
+            using ins_t = meta::list<integral_constant<int, Ins>...>;
+        };
+
+        template <class>
+        struct extents_dims;
+
+        template <class... Ts>
+        struct extents_dims<extents<Ts...>> {
+            using type = meta::list<typename Ts::dim_t...>;
+        };
+
+        template <class Lhs, class Rhs>
+        struct equal_extents {
+            template <class Dim>
+            using is_equal_along = std::is_same<extent_at<Lhs, Dim>, extent_at<Rhs, Dim>>;
+
+            static constexpr bool value = meta::all_of<is_equal_along,
+                meta::concat<typename extents_dims<Lhs>::type, typename extents_dims<Rhs>::type>>::value;
+        };
+
+        template <class Extents>
+        using is_zero_extents = equal_extents<Extents, extents<>>;
+
+        // The compute extents of all stages, computed from the last stage to the first one. Stages that do not write a
+        // local temporary are computed on the domain only.
+        template <class LocalTmps, class Stages>
+        struct compute_extents;
+
+        template <class LocalTmps>
+        struct compute_extents<LocalTmps, meta::list<>> {
+            using type = meta::list<>;
+        };
+
+        template <class LocalTmps, class Stage, class... Stages>
+        struct compute_extents<LocalTmps, meta::list<Stage, Stages...>> {
+            using rest_t = typename compute_extents<LocalTmps, meta::list<Stages...>>::type;
+            using out_t = typename stage_info<Stage>::out_t;
+
+            template <class Consumer, class ConsumerExtents>
+            using required_extents = meta::if_<meta::st_contains<typename stage_info<Consumer>::ins_t, out_t>,
+                sum_extents<ConsumerExtents, typename stage_info<Consumer>::type>,
+                extents<>>;
+
+            using type = meta::push_front<rest_t,
+                meta::if_<meta::st_contains<LocalTmps, out_t>,
+                    meta::rename<enclosing_extents, meta::transform<required_extents, meta::list<Stages...>, rest_t>>,
+                    extents<>>>;
+        };
+
+        /*
+         * Fusion must not change the result: a field that is not a local temporary and that is written by one stage
+         * may only be accessed at the current point by the other stages.
+         */
+        template <class LocalTmps, class Producer, class Consumer>
+        struct is_valid_pair {
+            using producer_t = stage_info<meta::first<Producer>>;
+            using consumer_t = stage_info<meta::first<Consumer>>;
+
+            template <class Writer, class Reader, class ReaderExtents>
+            static constexpr bool is_pointwise() {
+                using out_t = typename Writer::out_t;
+                return meta::st_contains<LocalTmps, out_t>::value ||
+                       !meta::st_contains<typename Reader::ins_t, out_t>::value ||
+                       is_zero_extents<sum_extents<ReaderExtents, typename Reader::type>>::value;
+            }
+
+            static constexpr bool value =
+                is_pointwise<producer_t, consumer_t, meta::second<Consumer>>() &&
+                is_pointwise<consumer_t, producer_t, meta::second<Producer>>() &&
+                (!meta::st_contains<typename consumer_t::ins_t, typename producer_t::out_t>::value ||
+                    !meta::st_contains<LocalTmps, typename producer_t::out_t>::value ||
+                    consumer_t::has_extents_t::value);
+        };
+
+        template <class LocalTmps, class Items>
+        struct is_fusable;
+
+        template <class LocalTmps>
+        struct is_fusable<LocalTmps, meta::list<>> : std::true_type {};
+
+        template <class LocalTmps, class Item, class... Items>
+        struct is_fusable<LocalTmps, meta::list<Item, Items...>>
+            : std::bool_constant<(is_valid_pair<LocalTmps, Item, Items>::value && ...) &&
+                                 is_fusable<LocalTmps, meta::list<Items...>>::value> {};
+
+        template <class Extents, class... Stages>
+        struct fused_stage : merged_stencil_stage<Stages...> {
+            using extents_t = Extents;
+            using outs_t = meta::list<typename stage_info<Stages>::out_t...>;
+        };
+
+        template <class Stage, class Extents, class FusedStages>
+        struct prepend_stage {
+            using type = meta::push_front<FusedStages, fused_stage<Extents, Stage>>;
+        };
+
+        template <class Stage, class Extents, class FirstExtents, class... FirstStages, class... FusedStages>
+        struct prepend_stage<Stage, Extents, meta::list<fused_stage<FirstExtents, FirstStages...>, FusedStages...>> {
+            using type = meta::if_<equal_extents<Extents, FirstExtents>,
+                meta::list<fused_stage<Extents, Stage, FirstStages...>, FusedStages...>,
+                meta::list<fused_stage<Extents, Stage>, fused_stage<FirstExtents, FirstStages...>, FusedStages...>>;
+        };
+
+        template <class Items>
+        struct merge_stages;
+
+        template <>
+        struct merge_stages<meta::list<>> {
+            using type = meta::list<>;
+        };
+
+        template <class Item, class... Items>
+        struct merge_stages<meta::list<Item, Items...>> {
+            using type = typename prepend_stage<meta::first<Item>,
+                meta::second<Item>,
+                typename merge_stages<meta::list<Items...>>::type>::type;
+        };
+
+        template <class Sids>
+        struct local_tmp_indices {
+            template <class I>
+            using is_local_tmp_at = is_local_tmp<std::decay_t<std::tuple_element_t<I::value, Sids>>>;
+
+            using type = meta::filter<is_local_tmp_at,
+                meta::iseq_to_list<std::make_integer_sequence<int, std::tuple_size_v<Sids>>,
+                    meta::list,
+                    integral_constant>>;
+        };
+
+        template <class Sids>
+        using has_local_tmps = std::negation<meta::is_empty<typename local_tmp_indices<std::decay_t<Sids>>::type>>;
+
+        template <class StageSpecs, class Sids>
+        struct make_fused_stages {
+            using local_tmps_t = typename local_tmp_indices<std::decay_t<Sids>>::type;
+            using stages_t = meta::rename<meta::list, StageSpecs>;
+            using items_t = meta::zip<stages_t, typename compute_extents<local_tmps_t, stages_t>::type>;
+
+            template <class Item>
+            using item_out = typename stage_info<meta::first<Item>>::out_t;
+            using outs_t = meta::transform<item_out, items_t>;
+
+            template <class I>
+            struct is_written_once {
+                template <class Out>
+                using is_same_out = std::is_same<Out, I>;
+
+                static constexpr bool value = meta::length<meta::filter<is_same_out, outs_t>>::value == 1;
+            };
+
+            static_assert(meta::all_of<is_written_once, local_tmps_t>::value,
+                "each local temporary must be written by exactly one stage");
+            static_assert(is_fusable<local_tmps_t, items_t>::value,
+                "stages that read a local temporary must declare their extents and fields other than local "
+                "temporaries that are written by one stage may only be read at the current point by other stages");
+
+            using type = typename merge_stages<items_t>::type;
+        };
+
+        // The fused stages of the stencil stages `StageSpecs`. `Sids` is the type of the tuple of arguments, where the
+        // local temporaries are `local_tmp` placeholders.
+        template <class StageSpecs, class Sids>
+        using fused_stages = typename make_fused_stages<StageSpecs, Sids>::type;
+
+        template <class FusedStages, class I>
+        struct local_tmp_extents_impl {
+            template <class FusedStage>
+            using writes = meta::st_contains<typename FusedStage::outs_t, I>;
+
+            using type = typename meta::first<meta::filter<writes, FusedStages>>::extents_t;
+        };
+
+        // The compute extents of the stage that writes the local temporary at argument index `I`
+        template <class FusedStages, class I>
+        using local_tmp_extents = typename local_tmp_extents_impl<FusedStages, I>::type;
+    } // namespace stage_fusion_impl_
+
+    using stage_fusion_impl_::fused_stages;
+    using stage_fusion_impl_::has_local_tmps;
+    using stage_fusion_impl_::is_local_tmp;
+    using stage_fusion_impl_::local_tmp_extents;
+} // namespace gridtools::fn
@@ -303,6 +303,19 @@ namespace gridtools {
             */
             void wait() { hd.wait(); }
 
+            /**
+               function to enable (or disable) persistent MPI requests. They are created at the first exchange and
+               reused as long as the same number of fields is exchanged.
+            */
+            void use_persistent_requests(bool enable = true) { hd.use_persistent_requests(enable); }
+
+            /**
+               function to enable (or disable) the exchange through MPI datatypes describing the halos of the fields
+               (CPU only). The fields passed to pack() are then read and updated by the exchange itself, and pack()
+               and unpack() do not copy data. The datatypes are reused as long as the same fields are packed.
+            */
+            void use_mpi_datatypes(bool enable = true) { hd.use_mpi_datatypes(enable); }
+
             grid_type const &comm() const { return hd.comm(); }
         };
 
@@ -461,6 +474,12 @@ namespace gridtools {
                and vice versa.
             */
             void wait() { hd.wait(); }
+
+            /**
+               function to enable (or disable) persistent MPI requests. They are created at the first exchange and
+               reused at the following ones.
+            */
+            void use_persistent_requests(bool enable = true) { hd.use_persistent_requests(enable); }
         };
 
         template <typename layout2proc_map, typename Gcl_Arch = cpu>
@@ -0,0 +1,103 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "../../common/array.hpp"
+
+namespace gridtools {
+    namespace gcl {
+        namespace _impl {
+            /**
+               A k-plane of a field in the message to (or from) a neighbor
+             */
+            struct plane_item {
+                char *message; // the beginning of the data of the field in the buffer of the neighbor
+                array<int, 3> eta;
+                int field;
+                int plane;
+            };
+
+            template <bool Pack, typename Translate, typename Buffers, typename IsNeighbor, typename Visit>
+            void cpu_transfer(
+                Buffers const &buffers, IsNeighbor const &is_neighbor, int num_fields, Visit const &visit) {
+                // the offsets of all the planes are computed up front, so the planes can be copied in any order
+                std::vector<plane_item> items;
+                for (int ii = -1; ii <= 1; ++ii) {
+                    for (int jj = -1; jj <= 1; ++jj) {
+                        for (int kk = -1; kk <= 1; ++kk) {
+                            if (ii == 0 && jj == 0 && kk == 0)
+                                continue;
+                            array<int, 3> eta = {ii, jj, kk};
+                            char *message = reinterpret_cast<char *>(&(buffers[Translate()(ii, jj, kk)][0]));
+                            bool active = true;
+                            for (int f = 0; active && f < num_fields; ++f) {
+                                visit(f, [&](auto const &field, auto *ptr) {
+                                    active = is_neighbor(field, eta);
+                                    if (!active)
+                                        return;
+                                    using value_t = std::remove_pointer_t<decltype(ptr)>;
+                                    int planes = Pack ? field.send_planes(eta) : field.recv_planes(eta);
+                                    for (int p = 0; p < planes; ++p)
+                                        items.push_back({message, eta, f, p});
+                                    message += (Pack ? field.send_buffer_size(eta) : field.recv_buffer_size(eta)) *
+                                               sizeof(value_t);
+                                });
+                            }
+                        }
+                    }
+                }
+
+                std::ptrdiff_t num_items = items.size();
+#pragma omp parallel for schedule(dynamic, 1)
+                for (std::ptrdiff_t i = 0; i < num_items; ++i) {
+                    plane_item const &item = items[i];
+                    visit(item.field, [&](auto const &field, auto *ptr) {
+                        if constexpr (Pack)
+                            field.pack_plane(item.eta, ptr, item.plane, item.message);
+                        else
+                            field.unpack_plane(item.eta, ptr, item.plane, item.message);
+                    });
+                }
+            }
+        } // namespace _impl
+
+        /**
+           Packs the data of the fields into the buffers of the neighbors.
+
+           The buffer of the neighbor `eta` contains the data of the fields one after the other, each with the
+           k-planes in increasing order, as produced by `empty_field_no_dt::pack`. The planes of all the fields and
+           neighbors are packed in parallel, each by contiguous copies of the rows of the plane.
+
+           \tparam Translate Mapping of the neighbors to the indices of the buffers
+           \param[in] buffers The buffers of the neighbors
+           \param[in] is_neighbor `is_neighbor(field, eta)` tells if the data of `field` is sent to `eta`. At the
+           first field for which it does not hold, the remaining fields are skipped for `eta`.
+           \param[in] num_fields The number of fields
+           \param[in] visit `visit(f, fun)` calls `fun(field, ptr)` for the field descriptor and the data pointer of
+           the field number `f`
+         */
+        template <typename Translate, typename Buffers, typename IsNeighbor, typename Visit>
+        void cpu_pack(Buffers const &buffers, IsNeighbor const &is_neighbor, int num_fields, Visit const &visit) {
+            _impl::cpu_transfer<true, Translate>(buffers, is_neighbor, num_fields, visit);
+        }
+
+        /**
+           Unpacks the data received from the neighbors into the fields, the reverse of `cpu_pack`
+         */
+        template <typename Translate, typename Buffers, typename IsNeighbor, typename Visit>
+        void cpu_unpack(Buffers const &buffers, IsNeighbor const &is_neighbor, int num_fields, Visit const &visit) {
+            _impl::cpu_transfer<false, Translate>(buffers, is_neighbor, num_fields, visit);
+        }
+    } // namespace gcl
+} // namespace gridtools
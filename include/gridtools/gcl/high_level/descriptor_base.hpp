@@ -70,6 +70,11 @@ namespace gridtools {
             */
             void wait() { m_haloexch.wait(); }
 
+            /**
+               function to enable (or disable) persistent MPI requests, see Halo_Exchange_3D::use_persistent_requests
+            */
+            void use_persistent_requests(bool enable = true) { m_haloexch.use_persistent_requests(enable); }
+
             /**
                Retrieve the pattern from which the computing grid and other information
                can be retrieved. The function is available only if the underlying
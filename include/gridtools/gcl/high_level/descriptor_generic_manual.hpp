@@ -52,10 +52,13 @@
 #undef GCL_KERNEL_TYPE
 #endif
 
+#include <tuple>
+#include <utility>
 #include <vector>
 
 #include "../../common/array.hpp"
 #include "../low_level/translate.hpp"
+#include "cpu_pack.hpp"
 #include "field_on_the_fly.hpp"
 #include "helpers_impl.hpp"
 #include "numerics.hpp"
@@ -211,26 +214,14 @@ namespace gridtools {
 
             template <typename... FIELDS>
             void pack(const FIELDS &..._fields) const {
-                for (int ii = -1; ii <= 1; ++ii) {
-                    for (int jj = -1; jj <= 1; ++jj) {
-                        for (int kk = -1; kk <= 1; ++kk) {
-                            char *it = reinterpret_cast<char *>(&(send_buffer[translate()(ii, jj, kk)][0]));
-                            pack_dims<DIMS_t::value, 0>()(*this, ii, jj, kk, it, _fields...);
-                        }
-                    }
-                }
+                cpu_pack<translate>(
+                    send_buffer, is_neighbor(), sizeof...(FIELDS), variadic_visitor<FIELDS...>{std::tie(_fields...)});
             }
 
             template <typename... FIELDS>
             void unpack(const FIELDS &..._fields) const {
-                for (int ii = -1; ii <= 1; ++ii) {
-                    for (int jj = -1; jj <= 1; ++jj) {
-                        for (int kk = -1; kk <= 1; ++kk) {
-                            char *it = reinterpret_cast<char *>(&(recv_buffer[translate()(ii, jj, kk)][0]));
-                            unpack_dims<DIMS_t::value, 0>()(*this, ii, jj, kk, it, _fields...);
-                        }
-                    }
-                }
+                cpu_unpack<translate>(
+                    recv_buffer, is_neighbor(), sizeof...(FIELDS), variadic_visitor<FIELDS...>{std::tie(_fields...)});
             }
 
             /**
@@ -241,16 +232,7 @@ namespace gridtools {
             */
             template <typename T1, typename T2, template <typename> class T3>
             void pack(std::vector<field_on_the_fly<T1, T2, T3>> const &fields) {
-                for (int ii = -1; ii <= 1; ++ii) {
-                    for (int jj = -1; jj <= 1; ++jj) {
-                        for (int kk = -1; kk <= 1; ++kk) {
-                            typename field_on_the_fly<T1, T2, T3>::value_type *it =
-                                reinterpret_cast<typename field_on_the_fly<T1, T2, T3>::value_type *>(
-                                    &(send_buffer[translate()(ii, jj, kk)][0]));
-                            pack_vector_dims<DIMS_t::value, 0>()(*this, ii, jj, kk, it, fields);
-                        }
-                    }
-                }
+                cpu_pack<translate>(send_buffer, is_neighbor(), fields.size(), vector_visitor<T1, T2, T3>{fields});
             }
 
             /**
@@ -261,106 +243,46 @@ namespace gridtools {
             */
             template <typename T1, typename T2, template <typename> class T3>
             void unpack(std::vector<field_on_the_fly<T1, T2, T3>> const &fields) {
-                for (int ii = -1; ii <= 1; ++ii) {
-                    for (int jj = -1; jj <= 1; ++jj) {
-                        for (int kk = -1; kk <= 1; ++kk) {
-                            typename field_on_the_fly<T1, T2, T3>::value_type *it =
-                                reinterpret_cast<typename field_on_the_fly<T1, T2, T3>::value_type *>(
-                                    &(recv_buffer[translate()(ii, jj, kk)][0]));
-                            unpack_vector_dims<DIMS_t::value, 0>()(*this, ii, jj, kk, it, fields);
-                        }
-                    }
-                }
+                cpu_unpack<translate>(recv_buffer, is_neighbor(), fields.size(), vector_visitor<T1, T2, T3>{fields});
             }
 
           private:
-            template <int, int>
-            struct pack_dims {};
-
-            template <int dummy>
-            struct pack_dims<3, dummy> {
-
-                template <typename T, typename iterator>
-                void operator()(const T &, int, int, int, iterator &) const {}
-
-                template <typename T, typename iterator, typename FIRST, typename... FIELDS>
-                void operator()(
-                    const T &hm, int ii, int jj, int kk, iterator &it, FIRST const &first, const FIELDS &..._fields)
-                    const {
-                    using proc_layout = layout_transform<typename FIRST::inner_layoutmap, proc_layout_abs>;
-                    const int ii_P = nth<proc_layout, 0>(ii, jj, kk);
-                    const int jj_P = nth<proc_layout, 1>(ii, jj, kk);
-                    const int kk_P = nth<proc_layout, 2>(ii, jj, kk);
-                    if ((ii != 0 || jj != 0 || kk != 0) && (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                        first.pack({ii, jj, kk}, first.ptr, it);
-                        operator()(hm, ii, jj, kk, it, _fields...);
-                    }
+            struct is_neighbor_t {
+                hndlr_generic const *hm;
+
+                template <typename Field>
+                bool operator()(Field const &, array<int, 3> const &eta) const {
+                    using proc_layout = layout_transform<typename Field::inner_layoutmap, proc_layout_abs>;
+                    return hm->pattern().proc_grid().proc(nth<proc_layout, 0>(eta[0], eta[1], eta[2]),
+                               nth<proc_layout, 1>(eta[0], eta[1], eta[2]),
+                               nth<proc_layout, 2>(eta[0], eta[1], eta[2])) != -1;
                 }
             };
 
-            template <int, int>
-            struct unpack_dims {};
-
-            template <int dummy>
-            struct unpack_dims<3, dummy> {
-
-                template <typename T, typename iterator>
-                void operator()(const T &, int, int, int, iterator &) const {}
-
-                template <typename T, typename iterator, typename FIRST, typename... FIELDS>
-                void operator()(
-                    const T &hm, int ii, int jj, int kk, iterator &it, FIRST const &first, const FIELDS &..._fields)
-                    const {
-                    using proc_layout = layout_transform<typename FIRST::inner_layoutmap, proc_layout_abs>;
-                    const int ii_P = nth<proc_layout, 0>(ii, jj, kk);
-                    const int jj_P = nth<proc_layout, 1>(ii, jj, kk);
-                    const int kk_P = nth<proc_layout, 2>(ii, jj, kk);
-                    if ((ii != 0 || jj != 0 || kk != 0) && (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                        first.unpack({ii, jj, kk}, first.ptr, it);
-                        operator()(hm, ii, jj, kk, it, _fields...);
-                    }
+            is_neighbor_t is_neighbor() const { return {this}; }
+
+            template <typename... FIELDS>
+            struct variadic_visitor {
+                std::tuple<FIELDS const &...> fields;
+
+                template <typename Fun>
+                void operator()(int f, Fun const &fun) const {
+                    visit(f, fun, std::index_sequence_for<FIELDS...>());
                 }
-            };
 
-            template <int, int>
-            struct pack_vector_dims {};
-
-            template <int dummy>
-            struct pack_vector_dims<3, dummy> {
-
-                template <typename T, typename iterator, typename array_of_fotf>
-                void operator()(const T &hm, int ii, int jj, int kk, iterator &it, array_of_fotf const &_fields) const {
-                    using proc_layout =
-                        layout_transform<typename array_of_fotf::value_type::inner_layoutmap, proc_layout_abs>;
-                    const int ii_P = nth<proc_layout, 0>(ii, jj, kk);
-                    const int jj_P = nth<proc_layout, 1>(ii, jj, kk);
-                    const int kk_P = nth<proc_layout, 2>(ii, jj, kk);
-                    if ((ii != 0 || jj != 0 || kk != 0) && (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                        for (unsigned int fi = 0; fi < _fields.size(); ++fi) {
-                            _fields[fi].pack({ii, jj, kk}, _fields[fi].ptr, it);
-                        }
-                    }
+                template <typename Fun, size_t... Is>
+                void visit(int f, Fun const &fun, std::index_sequence<Is...>) const {
+                    (void)((f == int(Is) && (fun(std::get<Is>(fields), std::get<Is>(fields).ptr), true)) || ...);
                 }
             };
 
-            template <int, int>
-            struct unpack_vector_dims {};
-
-            template <int dummy>
-            struct unpack_vector_dims<3, dummy> {
-
-                template <typename T, typename iterator, typename array_of_fotf>
-                void operator()(const T &hm, int ii, int jj, int kk, iterator &it, array_of_fotf const &_fields) const {
-                    using proc_layout =
-                        layout_transform<typename array_of_fotf::value_type::inner_layoutmap, proc_layout_abs>;
-                    const int ii_P = nth<proc_layout, 0>(ii, jj, kk);
-                    const int jj_P = nth<proc_layout, 1>(ii, jj, kk);
-                    const int kk_P = nth<proc_layout, 2>(ii, jj, kk);
-                    if ((ii != 0 || jj != 0 || kk != 0) && (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                        for (unsigned int fi = 0; fi < _fields.size(); ++fi) {
-                            _fields[fi].unpack({ii, jj, kk}, _fields[fi].ptr, it);
-                        }
-                    }
+            template <typename T1, typename T2, template <typename> class T3>
+            struct vector_visitor {
+                std::vector<field_on_the_fly<T1, T2, T3>> const &fields;
+
+                template <typename Fun>
+                void operator()(int f, Fun const &fun) const {
+                    fun(fields[f], fields[f].ptr);
                 }
             };
         };
@@ -9,6 +9,9 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <vector>
 
 #include "../../common/array.hpp"
@@ -16,6 +19,7 @@
 #include "../low_level/proc_grids_3D.hpp"
 #include "../low_level/translate.hpp"
 #include "access.hpp"
+#include "cpu_pack.hpp"
 #include "descriptor_base.hpp"
 #include "empty_field_base.hpp"
 #include "helpers_impl.hpp"
@@ -57,38 +61,100 @@ namespace gridtools {
 
             const halo_descriptor *raw_array() const { return &(base_type::halos[0]); }
 
+            /**
+               Number of k-planes of the data sent to the neighbor eta
+            */
+            int send_planes(array<int, 3> const &eta) const { return halos[2].s_length(eta[2]); }
+
+            /**
+               Number of k-planes of the data received from the neighbor eta
+            */
+            int recv_planes(array<int, 3> const &eta) const { return halos[2].r_length(eta[2]); }
+
+            /**
+               Copies the k-plane number `plane` of the data sent to the neighbor eta into the message that starts
+               at `message`. The rows of the plane are contiguous both in the field and in the message.
+            */
+            template <typename DataType>
+            void pack_plane(array<int, 3> const &eta, DataType const *field_ptr, int plane, char *message) const {
+                const int i_begin = halos[0].loop_low_bound_inside(eta[0]);
+                const int j_begin = halos[1].loop_low_bound_inside(eta[1]);
+                const int k = halos[2].loop_low_bound_inside(eta[2]) + plane;
+                const size_t row = halos[0].s_length(eta[0]) * sizeof(DataType);
+                const int rows = halos[1].s_length(eta[1]);
+                message += size_t(plane) * rows * row;
+                for (int j = j_begin; j < j_begin + rows; ++j) {
+                    std::memcpy(message,
+                        field_ptr + access(i_begin, j, k, halos[0].total_length(), halos[1].total_length()),
+                        row);
+                    message += row;
+                }
+            }
+
+            /**
+               Copies the k-plane number `plane` of the data received from the neighbor eta from the message that
+               starts at `message` into the field.
+            */
+            template <typename DataType>
+            void unpack_plane(array<int, 3> const &eta, DataType *field_ptr, int plane, char const *message) const {
+                const int i_begin = halos[0].loop_low_bound_outside(eta[0]);
+                const int j_begin = halos[1].loop_low_bound_outside(eta[1]);
+                const int k = halos[2].loop_low_bound_outside(eta[2]) + plane;
+                const size_t row = halos[0].r_length(eta[0]) * sizeof(DataType);
+                const int rows = halos[1].r_length(eta[1]);
+                message += size_t(plane) * rows * row;
+                for (int j = j_begin; j < j_begin + rows; ++j) {
+                    std::memcpy(field_ptr + access(i_begin, j, k, halos[0].total_length(), halos[1].total_length()),
+                        message,
+                        row);
+                    message += row;
+                }
+            }
+
+            /**
+               MPI subarray datatype (not committed) of the data sent to the neighbor eta, made of elements of type
+               `element`. There must be data to send.
+            */
+            MPI_Datatype send_subarray(array<int, 3> const &eta, MPI_Datatype element) const {
+                int sizes[3], subsizes[3], starts[3];
+                for (int i = 0; i < 3; ++i) {
+                    sizes[i] = halos[i].total_length();
+                    subsizes[i] = halos[i].s_length(eta[i]);
+                    starts[i] = halos[i].loop_low_bound_inside(eta[i]);
+                }
+                MPI_Datatype res;
+                MPI_Type_create_subarray(3, sizes, subsizes, starts, MPI_ORDER_FORTRAN, element, &res);
+                return res;
+            }
+
+            /**
+               MPI subarray datatype (not committed) of the data received from the neighbor eta, made of elements of
+               type `element`. There must be data to receive.
+            */
+            MPI_Datatype recv_subarray(array<int, 3> const &eta, MPI_Datatype element) const {
+                int sizes[3], subsizes[3], starts[3];
+                for (int i = 0; i < 3; ++i) {
+                    sizes[i] = halos[i].total_length();
+                    subsizes[i] = halos[i].r_length(eta[i]);
+                    starts[i] = halos[i].loop_low_bound_outside(eta[i]);
+                }
+                MPI_Datatype res;
+                MPI_Type_create_subarray(3, sizes, subsizes, starts, MPI_ORDER_FORTRAN, element, &res);
+                return res;
+            }
+
             template <typename iterator_in, typename iterator_out>
             void pack(array<int, 3> const &eta, iterator_in const *field_ptr, iterator_out *&it) const {
-                for (int k = halos[2].loop_low_bound_inside(eta[2]); k <= halos[2].loop_high_bound_inside(eta[2]);
-                     ++k) {
-                    for (int j = halos[1].loop_low_bound_inside(eta[1]); j <= halos[1].loop_high_bound_inside(eta[1]);
-                         ++j) {
-                        for (int i = halos[0].loop_low_bound_inside(eta[0]);
-                             i <= halos[0].loop_high_bound_inside(eta[0]);
-                             ++i) {
-                            *(reinterpret_cast<iterator_in *>(it)) =
-                                field_ptr[access(i, j, k, halos[0].total_length(), halos[1].total_length())];
-                            reinterpret_cast<char *&>(it) += sizeof(iterator_in);
-                        }
-                    }
-                }
+                for (int plane = 0; plane < send_planes(eta); ++plane)
+                    pack_plane(eta, field_ptr, plane, reinterpret_cast<char *>(it));
+                reinterpret_cast<char *&>(it) += send_buffer_size(eta) * sizeof(iterator_in);
             }
 
             template <typename iterator_in, typename iterator_out>
             void unpack(array<int, 3> const &eta, iterator_in *field_ptr, iterator_out *&it) const {
-                for (int k = halos[2].loop_low_bound_outside(eta[2]); k <= halos[2].loop_high_bound_outside(eta[2]);
-                     ++k) {
-                    for (int j = halos[1].loop_low_bound_outside(eta[1]); j <= halos[1].loop_high_bound_outside(eta[1]);
-                         ++j) {
-                        for (int i = halos[0].loop_low_bound_outside(eta[0]);
-                             i <= halos[0].loop_high_bound_outside(eta[0]);
-                             ++i) {
-                            field_ptr[access(i, j, k, halos[0].total_length(), halos[1].total_length())] =
-                                *(reinterpret_cast<iterator_in *>(it));
-                            reinterpret_cast<char *&>(it) += sizeof(iterator_in);
-                        }
-                    }
-                }
+                for (int plane = 0; plane < recv_planes(eta); ++plane)
+                    unpack_plane(eta, field_ptr, plane, reinterpret_cast<char const *>(it));
+                reinterpret_cast<char *&>(it) += recv_buffer_size(eta) * sizeof(iterator_in);
             }
 
             template <typename iterator>
@@ -381,6 +447,10 @@ namespace gridtools {
             array<int, static_pow3(DIMS)> send_size;
             array<int, static_pow3(DIMS)> recv_size;
 
+            bool m_use_datatypes = false;
+            std::vector<DataType const *> m_datatype_fields; // the fields the datatypes are built for
+            std::vector<MPI_Datatype> m_datatypes;
+
           public:
             typedef cpu arch_type;
             typedef descriptor_base<HaloExch> base_type;
@@ -410,7 +480,10 @@ namespace gridtools {
             explicit hndlr_dynamic_ut(typename grid_type::period_type const &c, MPI_Comm const &comm)
                 : base_type(c, comm), halo(), send_buffer{nullptr}, recv_buffer{nullptr}, send_size{0}, recv_size{0} {}
 
-            ~hndlr_dynamic_ut() { _destroy_dynamic_ut<DIMS, 0>().do_it(this); }
+            ~hndlr_dynamic_ut() {
+                free_datatypes();
+                _destroy_dynamic_ut<DIMS, 0>().do_it(this);
+            }
 
             /**
                Constructor
@@ -439,6 +512,22 @@ namespace gridtools {
             */
             void setup(int max_fields_n) { allocation_service<this_type>()(this, max_fields_n); }
 
+            /**
+               Function to enable (or disable) the exchange through MPI datatypes. When enabled, pack() does not copy
+               the data into the buffers, but describes the halos of the fields by MPI subarray datatypes at their
+               absolute addresses, so that the MPI library reads and writes the fields directly. The halos of the
+               fields are then updated by the exchange itself and unpack() has nothing left to do. The datatypes are
+               built again only if pack() is called with different fields than the previous time; persistent requests
+               are then built again as well.
+
+               \param[in] enable true to use datatypes, false to use the buffers
+            */
+            void use_mpi_datatypes(bool enable = true) {
+                m_use_datatypes = enable;
+                if (!enable)
+                    free_datatypes();
+            }
+
             /**
                Function to pack data to be sent
 
@@ -489,6 +578,83 @@ namespace gridtools {
             friend struct allocation_service<this_type>;
 
           private:
+            // the persistent requests of the halo exchange may refer to the datatypes, see
+            // invalidate_persistent_requests()
+            void free_datatypes() {
+                if (!m_datatypes.empty())
+                    this->m_haloexch.invalidate_persistent_requests();
+                int finalized;
+                MPI_Finalized(&finalized);
+                if (!finalized)
+                    for (MPI_Datatype &type : m_datatypes)
+                        MPI_Type_free(&type);
+                m_datatypes.clear();
+                m_datatype_fields.clear();
+            }
+
+            // one struct of the subarrays of all the fields, at their absolute addresses
+            template <typename Fields>
+            MPI_Datatype make_datatype(Fields const &fields, MPI_Datatype subarray) {
+                std::vector<int> block_lengths(fields.size(), 1);
+                std::vector<MPI_Aint> addresses(fields.size());
+                std::vector<MPI_Datatype> types(fields.size(), subarray);
+                for (size_t i = 0; i < fields.size(); ++i)
+                    MPI_Get_address(fields[i], &addresses[i]);
+                MPI_Datatype res;
+                MPI_Type_create_struct(fields.size(), block_lengths.data(), addresses.data(), types.data(), &res);
+                MPI_Type_commit(&res);
+                MPI_Type_free(&subarray);
+                m_datatypes.push_back(res);
+                return res;
+            }
+
+            template <typename Fields>
+            void register_datatypes(Fields const &fields) {
+                if (!m_datatypes.empty() && m_datatype_fields.size() == fields.size() &&
+                    std::equal(fields.begin(), fields.end(), m_datatype_fields.begin()))
+                    return;
+                free_datatypes();
+                m_datatype_fields.assign(fields.begin(), fields.end());
+                // the same signature as the buffers, so that the other processes may use either
+                MPI_Datatype element;
+                MPI_Type_contiguous(sizeof(DataType), MPI_CHAR, &element);
+                for (int ii = -1; ii <= 1; ++ii) {
+                    for (int jj = -1; jj <= 1; ++jj) {
+                        for (int kk = -1; kk <= 1; ++kk) {
+                            typedef proc_layout map_type;
+                            const int ii_P = nth<map_type, 0>(ii, jj, kk);
+                            const int jj_P = nth<map_type, 1>(ii, jj, kk);
+                            const int kk_P = nth<map_type, 2>(ii, jj, kk);
+                            if ((ii == 0 && jj == 0 && kk == 0) || !is_neighbor(*this, {ii, jj, kk}))
+                                continue;
+                            const int s = send_size[translate()(ii, jj, kk)] * fields.size() * sizeof(DataType);
+                            if (s)
+                                this->m_haloexch.register_send_to_datatype(MPI_BOTTOM,
+                                    make_datatype(fields, halo.send_subarray({ii, jj, kk}, element)),
+                                    s,
+                                    ii_P,
+                                    jj_P,
+                                    kk_P);
+                            else
+                                this->m_haloexch.register_send_to_buffer(
+                                    send_buffer[translate()(ii, jj, kk)], 0, ii_P, jj_P, kk_P);
+                            const int r = recv_size[translate()(ii, jj, kk)] * fields.size() * sizeof(DataType);
+                            if (r)
+                                this->m_haloexch.register_receive_from_datatype(MPI_BOTTOM,
+                                    make_datatype(fields, halo.recv_subarray({ii, jj, kk}, element)),
+                                    r,
+                                    ii_P,
+                                    jj_P,
+                                    kk_P);
+                            else
+                                this->m_haloexch.register_receive_from_buffer(
+                                    recv_buffer[translate()(ii, jj, kk)], 0, ii_P, jj_P, kk_P);
+                        }
+                    }
+                }
+                MPI_Type_free(&element);
+            }
+
             template <int I, int dummy>
             struct pack_dims {};
 
@@ -496,33 +662,8 @@ namespace gridtools {
             struct pack_dims<3, dummy> {
                 template <typename T, typename... FIELDS>
                 void operator()(T &hm, const FIELDS &..._fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                    for (int ii = -1; ii <= 1; ++ii) {
-                        for (int jj = -1; jj <= 1; ++jj) {
-                            for (int kk = -1; kk <= 1; ++kk) {
-                                typedef proc_layout map_type;
-                                const int ii_P = nth<map_type, 0>(ii, jj, kk);
-                                const int jj_P = nth<map_type, 1>(ii, jj, kk);
-                                const int kk_P = nth<map_type, 2>(ii, jj, kk);
-                                if ((ii != 0 || jj != 0 || kk != 0) &&
-                                    (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                    DataType *it = &(hm.send_buffer[translate()(ii, jj, kk)][0]);
-                                    hm.halo.pack_all({ii, jj, kk}, it, _fields...);
-
-                                    hm.m_haloexch.set_send_to_size(
-                                        hm.send_size[translate()(ii, jj, kk)] * sizeof...(_fields) * sizeof(DataType),
-                                        ii_P,
-                                        jj_P,
-                                        kk_P);
-                                    hm.m_haloexch.set_receive_from_size(
-                                        hm.recv_size[translate()(ii, jj, kk)] * sizeof...(_fields) * sizeof(DataType),
-                                        ii_P,
-                                        jj_P,
-                                        kk_P);
-                                }
-                            }
-                        }
-                    }
+                    std::array<DataType const *, sizeof...(FIELDS)> fields = {_fields...};
+                    pack_vector_dims<3, dummy>::do_it(hm, fields);
                 }
             };
 
@@ -533,25 +674,19 @@ namespace gridtools {
             struct unpack_dims<3, dummy> {
                 template <typename T, typename... FIELDS>
                 void operator()(const T &hm, const FIELDS &..._fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                    for (int ii = -1; ii <= 1; ++ii) {
-                        for (int jj = -1; jj <= 1; ++jj) {
-                            for (int kk = -1; kk <= 1; ++kk) {
-                                typedef proc_layout map_type;
-                                const int ii_P = nth<map_type, 0>(ii, jj, kk);
-                                const int jj_P = nth<map_type, 1>(ii, jj, kk);
-                                const int kk_P = nth<map_type, 2>(ii, jj, kk);
-                                if ((ii != 0 || jj != 0 || kk != 0) &&
-                                    (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                    DataType *it = &(hm.recv_buffer[translate()(ii, jj, kk)][0]);
-                                    hm.halo.unpack_all({ii, jj, kk}, it, _fields...);
-                                }
-                            }
-                        }
-                    }
+                    std::array<DataType *, sizeof...(FIELDS)> fields = {_fields...};
+                    unpack_vector_dims<3, dummy>::do_it(hm, fields);
                 }
             };
 
+            template <typename T>
+            static bool is_neighbor(const T &hm, array<int, 3> const &eta) {
+                typedef proc_layout map_type;
+                return hm.pattern().proc_grid().proc(nth<map_type, 0>(eta[0], eta[1], eta[2]),
+                           nth<map_type, 1>(eta[0], eta[1], eta[2]),
+                           nth<map_type, 2>(eta[0], eta[1], eta[2])) != -1;
+            }
+
             template <int I, int dummy>
             struct pack_vector_dims {};
 
@@ -559,7 +694,22 @@ namespace gridtools {
             struct pack_vector_dims<3, dummy> {
                 template <typename T>
                 void operator()(T &hm, std::vector<DataType *> const &fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
+                    do_it(hm, fields);
+                }
+
+                template <typename T, typename Fields>
+                static void do_it(T &hm, Fields const &fields) {
+                    if (hm.m_use_datatypes) {
+                        hm.register_datatypes(fields);
+                        return;
+                    }
+
+                    cpu_pack<translate>(
+                        hm.send_buffer,
+                        [&](auto const &, array<int, 3> const &eta) { return is_neighbor(hm, eta); },
+                        fields.size(),
+                        [&](int f, auto const &fun) { fun(hm.halo, fields[f]); });
+
                     for (int ii = -1; ii <= 1; ++ii) {
                         for (int jj = -1; jj <= 1; ++jj) {
                             for (int kk = -1; kk <= 1; ++kk) {
@@ -567,19 +717,13 @@ namespace gridtools {
                                 const int ii_P = nth<map_type, 0>(ii, jj, kk);
                                 const int jj_P = nth<map_type, 1>(ii, jj, kk);
                                 const int kk_P = nth<map_type, 2>(ii, jj, kk);
-                                if ((ii != 0 || jj != 0 || kk != 0) &&
-                                    (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                    DataType *it = &(hm.send_buffer[translate()(ii, jj, kk)][0]);
-                                    for (size_t i = 0; i < fields.size(); ++i) {
-                                        hm.halo.pack({ii, jj, kk}, fields[i], it);
-                                    }
-
-                                    hm.m_haloexch.set_send_to_size(
+                                if ((ii != 0 || jj != 0 || kk != 0) && is_neighbor(hm, {ii, jj, kk})) {
+                                    hm.m_haloexch.register_send_to_buffer(hm.send_buffer[translate()(ii, jj, kk)],
                                         hm.send_size[translate()(ii, jj, kk)] * fields.size() * sizeof(DataType),
                                         ii_P,
                                         jj_P,
                                         kk_P);
-                                    hm.m_haloexch.set_receive_from_size(
+                                    hm.m_haloexch.register_receive_from_buffer(hm.recv_buffer[translate()(ii, jj, kk)],
                                         hm.recv_size[translate()(ii, jj, kk)] * fields.size() * sizeof(DataType),
                                         ii_P,
                                         jj_P,
@@ -598,24 +742,20 @@ namespace gridtools {
             struct unpack_vector_dims<3, dummy> {
                 template <typename T>
                 void operator()(const T &hm, std::vector<DataType *> const &fields) const {
-#pragma omp parallel for schedule(dynamic, 1) collapse(3)
-                    for (int ii = -1; ii <= 1; ++ii) {
-                        for (int jj = -1; jj <= 1; ++jj) {
-                            for (int kk = -1; kk <= 1; ++kk) {
-                                typedef proc_layout map_type;
-                                const int ii_P = nth<map_type, 0>(ii, jj, kk);
-                                const int jj_P = nth<map_type, 1>(ii, jj, kk);
-                                const int kk_P = nth<map_type, 2>(ii, jj, kk);
-                                if ((ii != 0 || jj != 0 || kk != 0) &&
-                                    (hm.pattern().proc_grid().proc(ii_P, jj_P, kk_P) != -1)) {
-                                    DataType *it = &(hm.recv_buffer[translate()(ii, jj, kk)][0]);
-                                    for (size_t i = 0; i < fields.size(); ++i) {
-                                        hm.halo.unpack({ii, jj, kk}, fields[i], it);
-                                    }
-                                }
-                            }
-                        }
-                    }
+                    do_it(hm, fields);
+                }
+
+                template <typename T, typename Fields>
+                static void do_it(const T &hm, Fields const &fields) {
+                    // the exchange has written to the fields already
+                    if (hm.m_use_datatypes)
+                        return;
+
+                    cpu_unpack<translate>(
+                        hm.recv_buffer,
+                        [&](auto const &, array<int, 3> const &eta) { return is_neighbor(hm, eta); },
+                        fields.size(),
+                        [&](int f, auto const &fun) { fun(hm.halo, fields[f]); });
                 }
             };
 
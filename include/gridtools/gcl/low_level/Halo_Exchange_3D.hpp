@@ -9,6 +9,8 @@
  */
 #pragma once
 
+#include <vector>
+
 #include "../../common/defs.hpp"
 #include "../GCL.hpp"
 #include "translate.hpp"
@@ -149,6 +151,7 @@ namespace gridtools {
             class sr_buffers {
                 char *m_buffers[27]; // there is ona buffer more to allow for a simple indexing
                 int m_size[27];      // Sizes in bytes
+                MPI_Datatype m_type[27]; // MPI_DATATYPE_NULL if the data is a buffer of m_size bytes
               public:
                 explicit sr_buffers() {
                     m_buffers[0] = nullptr;
@@ -206,11 +209,111 @@ namespace gridtools {
                     m_size[24] = 0;
                     m_size[25] = 0;
                     m_size[26] = 0;
+
+                    for (int i = 0; i < 27; ++i)
+                        m_type[i] = MPI_DATATYPE_NULL;
                 }
 
                 char *&buffer(int I, int J, int K) { return m_buffers[translate()(I, J, K)]; }
+                char *buffer(int I, int J, int K) const { return m_buffers[translate()(I, J, K)]; }
                 int &size(int I, int J, int K) { return m_size[translate()(I, J, K)]; }
                 int size(int I, int J, int K) const { return m_size[translate()(I, J, K)]; }
+                MPI_Datatype &type(int I, int J, int K) { return m_type[translate()(I, J, K)]; }
+
+                // count and datatype to be passed to MPI
+                int count(int I, int J, int K) const {
+                    return m_type[translate()(I, J, K)] == MPI_DATATYPE_NULL ? m_size[translate()(I, J, K)] : 1;
+                }
+                MPI_Datatype datatype(int I, int J, int K) const {
+                    MPI_Datatype res = m_type[translate()(I, J, K)];
+                    return res == MPI_DATATYPE_NULL ? MPI_CHAR : res;
+                }
+
+                bool operator==(sr_buffers const &other) const {
+                    for (int i = 0; i < 27; ++i)
+                        if (m_buffers[i] != other.m_buffers[i] || m_size[i] != other.m_size[i] ||
+                            m_type[i] != other.m_type[i])
+                            return false;
+                    return true;
+                }
+            };
+
+            /**
+               Requests that are built once with MPI_Recv_init/MPI_Send_init and started at every exchange. They are
+               valid for the buffers (and sizes and datatypes) they were built for.
+             */
+            class persistent_requests {
+                std::vector<MPI_Request> m_recvs;
+                std::vector<MPI_Request> m_sends;
+                bool m_built = false;
+                sr_buffers m_send_buffers;
+                sr_buffers m_recv_buffers;
+
+                static void start(std::vector<MPI_Request> &requests) {
+                    if (!requests.empty())
+                        MPI_Startall(requests.size(), requests.data());
+                }
+
+                static void wait(std::vector<MPI_Request> &requests) {
+                    if (!requests.empty())
+                        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+                }
+
+              public:
+                persistent_requests() = default;
+
+                // a copy builds its own requests
+                persistent_requests(persistent_requests const &) {}
+
+                persistent_requests &operator=(persistent_requests const &) {
+                    free();
+                    return *this;
+                }
+
+                ~persistent_requests() { free(); }
+
+                void free() {
+                    int finalized;
+                    MPI_Finalized(&finalized);
+                    if (!finalized) {
+                        for (MPI_Request &r : m_recvs)
+                            MPI_Request_free(&r);
+                        for (MPI_Request &r : m_sends)
+                            MPI_Request_free(&r);
+                    }
+                    m_recvs.clear();
+                    m_sends.clear();
+                    m_built = false;
+                }
+
+                bool built_for(sr_buffers const &send_buffers, sr_buffers const &recv_buffers) const {
+                    return m_built && m_send_buffers == send_buffers && m_recv_buffers == recv_buffers;
+                }
+
+                void rebuild_for(sr_buffers const &send_buffers, sr_buffers const &recv_buffers) {
+                    free();
+                    m_built = true;
+                    m_send_buffers = send_buffers;
+                    m_recv_buffers = recv_buffers;
+                }
+
+                MPI_Request *add_receive() {
+                    m_recvs.push_back(MPI_REQUEST_NULL);
+                    return &m_recvs.back();
+                }
+
+                MPI_Request *add_send() {
+                    m_sends.push_back(MPI_REQUEST_NULL);
+                    return &m_sends.back();
+                }
+
+                void start_receives() { start(m_recvs); }
+                void start_sends() { start(m_sends); }
+
+                void wait() {
+                    wait(m_sends);
+                    wait(m_recvs);
+                }
             };
 
             template <int I, int J, int K>
@@ -243,14 +346,49 @@ namespace gridtools {
             request_t request;
             request_t_mark send_request;
 
+            bool m_persistent = false;
+            persistent_requests m_persistent_requests;
+
             const PROC_GRID /*&*/ m_proc_grid;
 
+            static int tag(int I, int J, int K) { return (K + 1) * 9 + (I + 1) * 3 + J + 1; }
+
+            void update_persistent_requests() {
+                if (m_persistent_requests.built_for(m_send_buffers, m_recv_buffers))
+                    return;
+                m_persistent_requests.rebuild_for(m_send_buffers, m_recv_buffers);
+                for (int i = -1; i <= 1; ++i)
+                    for (int j = -1; j <= 1; ++j)
+                        for (int k = -1; k <= 1; ++k)
+                            if ((i != 0 || j != 0 || k != 0) && m_proc_grid.proc(i, j, k) != -1 &&
+                                m_recv_buffers.size(i, j, k))
+                                MPI_Recv_init(m_recv_buffers.buffer(i, j, k),
+                                    m_recv_buffers.count(i, j, k),
+                                    m_recv_buffers.datatype(i, j, k),
+                                    m_proc_grid.proc(i, j, k),
+                                    tag(-i, -j, -k),
+                                    m_proc_grid.communicator(),
+                                    m_persistent_requests.add_receive());
+                for (int i = -1; i <= 1; ++i)
+                    for (int j = -1; j <= 1; ++j)
+                        for (int k = -1; k <= 1; ++k)
+                            if ((i != 0 || j != 0 || k != 0) && m_proc_grid.proc(i, j, k) != -1 &&
+                                m_send_buffers.size(i, j, k))
+                                MPI_Send_init(m_send_buffers.buffer(i, j, k),
+                                    m_send_buffers.count(i, j, k),
+                                    m_send_buffers.datatype(i, j, k),
+                                    m_proc_grid.proc(i, j, k),
+                                    tag(i, j, k),
+                                    m_proc_grid.communicator(),
+                                    m_persistent_requests.add_send());
+            }
+
             template <int I, int J, int K>
             void post_receive() {
                 if (m_recv_buffers.size(I, J, K)) {
                     MPI_Irecv(static_cast<char *>(m_recv_buffers.buffer(I, J, K)),
-                        m_recv_buffers.size(I, J, K),
-                        MPI_CHAR,
+                        m_recv_buffers.count(I, J, K),
+                        m_recv_buffers.datatype(I, J, K),
                         m_proc_grid.template proc<I, J, K>(),
                         TAG<-I, -J, -K>::value,
                         m_proc_grid.communicator(),
@@ -262,8 +400,8 @@ namespace gridtools {
             void perform_isend() {
                 if (m_send_buffers.size(I, J, K)) {
                     MPI_Isend(static_cast<char *>(m_send_buffers.buffer(I, J, K)),
-                        m_send_buffers.size(I, J, K),
-                        MPI_CHAR,
+                        m_send_buffers.count(I, J, K),
+                        m_send_buffers.datatype(I, J, K),
                         m_proc_grid.template proc<I, J, K>(),
                         TAG<I, J, K>::value,
                         m_proc_grid.communicator(),
@@ -337,6 +475,7 @@ namespace gridtools {
 
                 m_send_buffers.buffer(I, J, K) = reinterpret_cast<char *>(p);
                 m_send_buffers.size(I, J, K) = s;
+                m_send_buffers.type(I, J, K) = MPI_DATATYPE_NULL;
             }
 
             /** Function to register send buffers with the communication patter.
@@ -390,6 +529,7 @@ namespace gridtools {
 
                 m_recv_buffers.buffer(I, J, K) = reinterpret_cast<char *>(p);
                 m_recv_buffers.size(I, J, K) = s;
+                m_recv_buffers.type(I, J, K) = MPI_DATATYPE_NULL;
             }
 
             /** Function to register buffers for received data with the communication patter.
@@ -420,6 +560,68 @@ namespace gridtools {
                 register_receive_from_buffer(p, s, I, J, K);
             }
 
+            /** Function to register the data to be sent to neighbor I, J, K as an MPI datatype instead of a
+                buffer. One element of `type` starting at `p` is sent, so the MPI library reads the data from where
+                it is, for instance from the fields themselves if `type` describes their halos by absolute addresses
+                and `p` is MPI_BOTTOM. The datatype must be committed and stay valid as long as it is registered.
+                Registering a buffer for the same neighbor replaces the datatype.
+
+                \param[in] p Address the datatype is relative to
+                \param[in] type Committed MPI datatype describing the data to be sent
+                \param[in] s Number of bytes described by the datatype
+                \param[in] I Relative coordinates of the receiving process along the first dimension
+                \param[in] J Relative coordinates of the receiving process along the second dimension
+                \param[in] K Relative coordinates of the receiving process along the third dimension
+            */
+            void register_send_to_datatype(void const *p, MPI_Datatype type, int s, int I, int J, int K) {
+                assert((I >= -1 && I <= 1));
+                assert((J >= -1 && J <= 1));
+                assert((K >= -1 && K <= 1));
+
+                m_send_buffers.buffer(I, J, K) = reinterpret_cast<char *>(const_cast<void *>(p));
+                m_send_buffers.size(I, J, K) = s;
+                m_send_buffers.type(I, J, K) = type;
+            }
+
+            /** Function to register where the data received from neighbor I, J, K goes as an MPI datatype
+                instead of a buffer. See register_send_to_datatype.
+
+                \param[in] p Address the datatype is relative to
+                \param[in] type Committed MPI datatype describing where the received data is stored
+                \param[in] s Number of bytes described by the datatype
+                \param[in] I Relative coordinates of the sending process along the first dimension
+                \param[in] J Relative coordinates of the sending process along the second dimension
+                \param[in] K Relative coordinates of the sending process along the third dimension
+            */
+            void register_receive_from_datatype(void *p, MPI_Datatype type, int s, int I, int J, int K) {
+                assert((I >= -1 && I <= 1));
+                assert((J >= -1 && J <= 1));
+                assert((K >= -1 && K <= 1));
+
+                m_recv_buffers.buffer(I, J, K) = reinterpret_cast<char *>(p);
+                m_recv_buffers.size(I, J, K) = s;
+                m_recv_buffers.type(I, J, K) = type;
+            }
+
+            /** Function to enable (or disable) persistent requests. When enabled, the sends and receives are
+                created with MPI_Send_init/MPI_Recv_init at the first exchange and started with MPI_Startall at this
+                and every following exchange. They are created again only if a buffer, a size or a datatype has
+                changed since, so an exchange of the same fields at every time step pays for the setup once. Must not
+                be called between start_exchange() and wait().
+            */
+            void use_persistent_requests(bool enable = true) {
+                m_persistent = enable;
+                if (!enable)
+                    m_persistent_requests.free();
+            }
+
+            /** Function to drop the persistent requests, so that they are created again at the next exchange. Must be
+                called when a registered datatype is freed: the requests keep referring to it, while a datatype created
+                afterwards may get the same handle, so the change would not be noticed otherwise. Must not be called
+                between start_exchange() and wait().
+            */
+            void invalidate_persistent_requests() { m_persistent_requests.free(); }
+
             /* Setting sizes */
 
             /** Function to set send buffers sizes if the size must be updated
@@ -549,6 +751,12 @@ namespace gridtools {
             }
 
             void post_receives() {
+                if (m_persistent) {
+                    update_persistent_requests();
+                    m_persistent_requests.start_receives();
+                    return;
+                }
+
                 /* Posting receives face -1
                  */
                 if (m_proc_grid.template proc<1, 0, -1>() != -1) {
@@ -667,6 +875,11 @@ namespace gridtools {
             }
 
             void do_sends() {
+                if (m_persistent) {
+                    m_persistent_requests.start_sends();
+                    return;
+                }
+
                 /* Sending data face -1
                  */
                 if (m_proc_grid.template proc<-1, 0, -1>() != -1) {
@@ -813,6 +1026,10 @@ namespace gridtools {
             }
 
             void wait() {
+                if (m_persistent) {
+                    m_persistent_requests.wait();
+                    return;
+                }
 
                 wait_for_sends();
 
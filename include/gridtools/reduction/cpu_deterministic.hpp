@@ -0,0 +1,208 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * CPU reduction backend with results that do not depend on the number of threads or on the scheduling.
+ *
+ * The buffer is split into blocks of `block_size` elements. Each block is reduced into `lanes<T>` independent
+ * accumulators (element `i` of the block goes to accumulator `i % lanes<T>`, which lets the compiler vectorize the
+ * loop), which are then combined pairwise. The results of the blocks are combined by the same fixed pairwise tree.
+ * Only the reduction of whole blocks is distributed over the OpenMP threads, so the order of all operations is
+ * determined by the size of the buffer alone.
+ *
+ * With `cpu_deterministic<true>`, sums of floating point numbers are additionally compensated as in the Neumaier
+ * variant of Kahan summation: every accumulator carries the sum of the rounding errors of its additions. Note that
+ * compensation is defeated by compiling with `-ffast-math` or alike.
+ *
+ * As for the `cpu` backend, the initial value passed to `reduction_reduce` must be the neutral element of the
+ * reduction.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+#include "../common/defs.hpp"
+#include "functions.hpp"
+
+namespace gridtools {
+    namespace reduction {
+        template <bool Compensated = false>
+        struct cpu_deterministic {};
+
+        namespace cpu_deterministic_impl_ {
+            constexpr size_t block_size = 2048;
+            // the number of independent accumulators per block, enough to hide the latency of the additions
+            template <class T>
+            constexpr size_t lanes = std::max<size_t>(128 / sizeof(T), 1);
+
+            template <class F>
+            struct plain_accumulation {
+                F m_f;
+
+                template <class T>
+                T make(T const &val) const {
+                    return val;
+                }
+                template <class T>
+                T add(T const &acc, T const &val) const {
+                    return m_f(acc, val);
+                }
+                template <class T>
+                T merge(T const &lhs, T const &rhs) const {
+                    return m_f(lhs, rhs);
+                }
+                template <class T>
+                T result(T const &acc) const {
+                    return acc;
+                }
+            };
+
+            // adds `val` to `sum` and the rounding error of this addition to `compensation`; the error is computed
+            // exactly and without branches by Knuth's two-sum
+            template <class T>
+            void add_compensated(T &sum, T &compensation, T const &val) {
+                T res = sum + val;
+                T rounded_val = res - sum;
+                compensation += (sum - (res - rounded_val)) + (val - rounded_val);
+                sum = res;
+            }
+
+            template <class T>
+            struct compensated_sum {
+                T m_sum;
+                T m_compensation;
+            };
+
+            struct compensated_accumulation {
+                template <class T>
+                compensated_sum<T> make(T const &val) const {
+                    return {val, 0};
+                }
+                template <class T>
+                compensated_sum<T> add(compensated_sum<T> acc, T const &val) const {
+                    add_compensated(acc.m_sum, acc.m_compensation, val);
+                    return acc;
+                }
+                template <class T>
+                compensated_sum<T> merge(compensated_sum<T> const &lhs, compensated_sum<T> const &rhs) const {
+                    auto res = add(lhs, rhs.m_sum);
+                    res.m_compensation += rhs.m_compensation;
+                    return res;
+                }
+                template <class T>
+                T result(compensated_sum<T> const &acc) const {
+                    return acc.m_sum + acc.m_compensation;
+                }
+            };
+
+            // combines `vals[0], ..., vals[n - 1]` by a balanced binary tree that only depends on `n`
+            template <class Acc, class V>
+            V pairwise(Acc const &acc, V *vals, size_t n) {
+                for (; n > 1; n = (n + 1) / 2) {
+                    for (size_t i = 0; i != n / 2; ++i)
+                        vals[i] = acc.merge(vals[2 * i], vals[2 * i + 1]);
+                    if (n % 2)
+                        vals[n / 2] = vals[n - 1];
+                }
+                return vals[0];
+            }
+
+            template <class Acc, class T>
+            auto reduce_block(Acc const &acc, T const &neutral, T const *buff, size_t n) {
+                using acc_t = decltype(acc.make(neutral));
+                acc_t partials[lanes<T>];
+                for (size_t l = 0; l != lanes<T>; ++l)
+                    partials[l] = acc.make(neutral);
+                size_t i = 0;
+                for (; i + lanes<T> <= n; i += lanes<T>)
+                    for (size_t l = 0; l != lanes<T>; ++l)
+                        partials[l] = acc.add(partials[l], buff[i + l]);
+                for (size_t l = 0; i + l < n; ++l)
+                    partials[l] = acc.add(partials[l], buff[i + l]);
+                return pairwise(acc, partials, lanes<T>);
+            }
+
+            // the same with sums and compensations in separate arrays, which vectorizes better
+            template <class T>
+            compensated_sum<T> reduce_block(
+                compensated_accumulation const &acc, T const &neutral, T const *buff, size_t n) {
+                T sums[lanes<T>];
+                T compensations[lanes<T>] = {};
+                for (size_t l = 0; l != lanes<T>; ++l)
+                    sums[l] = neutral;
+                size_t i = 0;
+                for (; i + lanes<T> <= n; i += lanes<T>)
+                    for (size_t l = 0; l != lanes<T>; ++l)
+                        add_compensated(sums[l], compensations[l], buff[i + l]);
+                for (size_t l = 0; i + l < n; ++l)
+                    add_compensated(sums[l], compensations[l], buff[i + l]);
+                compensated_sum<T> partials[lanes<T>];
+                for (size_t l = 0; l != lanes<T>; ++l)
+                    partials[l] = {sums[l], compensations[l]};
+                return pairwise(acc, partials, lanes<T>);
+            }
+
+            template <class Acc, class T>
+            T reduce(Acc const &acc, T const &neutral, T const *buff, size_t n) {
+                using acc_t = decltype(acc.make(neutral));
+                std::ptrdiff_t num_blocks = (n + block_size - 1) / block_size;
+                if (num_blocks == 0)
+                    return neutral;
+                std::vector<acc_t> partials(num_blocks, acc.make(neutral));
+#pragma omp parallel for schedule(static)
+                for (std::ptrdiff_t b = 0; b < num_blocks; ++b) {
+                    size_t offset = b * block_size;
+                    partials[b] = reduce_block(acc, neutral, buff + offset, std::min(block_size, n - offset));
+                }
+                return acc.result(pairwise(acc, partials.data(), num_blocks));
+            }
+        } // namespace cpu_deterministic_impl_
+
+        template <bool Compensated, class F, class T>
+        T reduction_reduce(cpu_deterministic<Compensated>, T res, F f, T const *buff, size_t n) {
+            return cpu_deterministic_impl_::reduce(cpu_deterministic_impl_::plain_accumulation<F>{f}, res, buff, n);
+        }
+
+        template <class T, std::enable_if_t<std::is_floating_point_v<T>, int> = 0>
+        T reduction_reduce(cpu_deterministic<true>, T res, plus, T const *buff, size_t n) {
+            return cpu_deterministic_impl_::reduce(cpu_deterministic_impl_::compensated_accumulation(), res, buff, n);
+        }
+
+        template <bool Compensated>
+        size_t reduction_round_size(cpu_deterministic<Compensated>, size_t size) {
+            return size;
+        }
+
+        template <bool Compensated>
+        size_t reduction_allocation_size(cpu_deterministic<Compensated>, size_t size) {
+            return size;
+        }
+
+        template <bool Compensated, class T>
+        void reduction_fill(cpu_deterministic<Compensated>,
+            T const &val,
+            T *ptr,
+            size_t data_size,
+            size_t rounded_size,
+            bool has_holes) {
+            if (!has_holes) {
+                ptr += data_size;
+                rounded_size -= data_size;
+            }
+            std::fill(ptr, ptr + rounded_size, val);
+        }
+    } // namespace reduction
+} // namespace gridtools
@@ -0,0 +1,236 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * Several reductions of the same data in a single pass.
+ *
+ * `reduce_many(sid, f0, f1, ...)` returns `tuple(r0, r1, ...)` where `ri` is the reduction of all elements of `sid`
+ * with the functor `fi`, reading every element only once. `sid` is any SID with bounds and raw pointers to host
+ * memory; in particular a `reducible` or a data store that was the output of a stencil computation. Unlike
+ * `reducible::reduce`, only the elements within the bounds are visited, so no neutral value is needed and padding is
+ * not touched. Since there is no neutral value either, the SID must not be empty; otherwise `std::domain_error` is
+ * thrown.
+ *
+ * Besides the functors of functions.hpp, `mapped<Map, F>` reduces `Map` applied to the elements with `F`, for
+ * example `sum_sq` for the sum of squares.
+ *
+ * The innermost (smallest stride) dimension is cut into segments of at most `segment_size` elements, which are
+ * distributed over the OpenMP threads. The functors are applied to a segment one after the other, each with
+ * `lanes<T>` independent accumulators to allow vectorization; the segment stays in the L1 cache meanwhile. The partial
+ * results are combined in a fixed order, so the results do not depend on the number of threads.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../common/for_each.hpp"
+#include "../common/hymap.hpp"
+#include "../common/integral_constant.hpp"
+#include "../common/tuple.hpp"
+#include "../common/tuple_util.hpp"
+#include "../meta.hpp"
+#include "../sid/concept.hpp"
+#include "functions.hpp"
+
+namespace gridtools {
+    namespace reduction {
+        struct square {
+            template <class T>
+            GT_FUNCTION auto operator()(T const &x) const {
+                return x * x;
+            }
+        };
+
+        /**
+         *  Reduction of `Map` applied to the elements with `F`. Supported by `reduce_many` only.
+         */
+        template <class Map, class F>
+        struct mapped {
+            Map m_map;
+            F m_f;
+        };
+
+        inline constexpr mapped<square, plus> sum_sq = {};
+
+        namespace reduce_many_impl_ {
+            constexpr std::ptrdiff_t segment_size = 2048;
+
+            template <class T>
+            constexpr size_t lanes = std::max<size_t>(64 / sizeof(T), 1);
+
+            template <class F, class T>
+            T map(F const &, T const &val) {
+                return val;
+            }
+
+            template <class Map, class F, class T>
+            T map(mapped<Map, F> const &f, T const &val) {
+                return f.m_map(val);
+            }
+
+            template <class F, class T>
+            T combine(F const &f, T const &lhs, T const &rhs) {
+                return f(lhs, rhs);
+            }
+
+            template <class Map, class F, class T>
+            T combine(mapped<Map, F> const &f, T const &lhs, T const &rhs) {
+                return f.m_f(lhs, rhs);
+            }
+
+            struct dimension {
+                std::ptrdiff_t m_size;
+                std::ptrdiff_t m_stride;
+            };
+
+            template <class T, size_t N>
+            using results = meta::rename<tuple, meta::repeat_c<N, meta::list<T>>>;
+
+            // combines `vals[0], ..., vals[n - 1]` by a balanced binary tree that only depends on `n`
+            template <class Fs, class Results, size_t... Is>
+            Results pairwise(Fs const &fs, Results *vals, size_t n, std::index_sequence<Is...>) {
+                for (; n > 1; n = (n + 1) / 2) {
+                    for (size_t i = 0; i != n / 2; ++i)
+                        vals[i] = {combine(tuple_util::get<Is>(fs),
+                            tuple_util::get<Is>(vals[2 * i]),
+                            tuple_util::get<Is>(vals[2 * i + 1]))...};
+                    if (n % 2)
+                        vals[n / 2] = vals[n - 1];
+                }
+                return vals[0];
+            }
+
+            // reduces the `n > 0` elements `ptr[0], ptr[stride], ...` with `f`
+            template <class F, class T, class Stride>
+            T reduce_segment(F const &f, T const *ptr, Stride stride, std::ptrdiff_t n) {
+                constexpr std::ptrdiff_t num_lanes = lanes<T>;
+                if (n < num_lanes) {
+                    T res = map(f, ptr[0]);
+                    for (std::ptrdiff_t i = 1; i != n; ++i)
+                        res = combine(f, res, map(f, ptr[i * stride]));
+                    return res;
+                }
+                T partials[num_lanes];
+                for (std::ptrdiff_t l = 0; l != num_lanes; ++l)
+                    partials[l] = map(f, ptr[l * stride]);
+                std::ptrdiff_t i = num_lanes;
+                for (; i + num_lanes <= n; i += num_lanes)
+                    for (std::ptrdiff_t l = 0; l != num_lanes; ++l)
+                        partials[l] = combine(f, partials[l], map(f, ptr[(i + l) * stride]));
+                for (std::ptrdiff_t l = 0; i + l < n; ++l)
+                    partials[l] = combine(f, partials[l], map(f, ptr[(i + l) * stride]));
+                for (std::ptrdiff_t m = num_lanes; m > 1; m = (m + 1) / 2) {
+                    for (std::ptrdiff_t l = 0; l != m / 2; ++l)
+                        partials[l] = combine(f, partials[2 * l], partials[2 * l + 1]);
+                    if (m % 2)
+                        partials[m / 2] = partials[m - 1];
+                }
+                return partials[0];
+            }
+
+            // the segment is small enough to stay in the L1 cache, so it is read from memory only once even though
+            // the functors are applied one after the other
+            template <class Fs, class T, class Stride, size_t... Is>
+            results<T, sizeof...(Is)> reduce_segment(
+                Fs const &fs, T const *ptr, Stride stride, std::ptrdiff_t n, std::index_sequence<Is...>) {
+                return {reduce_segment(tuple_util::get<Is>(fs), ptr, stride, n)...};
+            }
+
+            template <class Sid>
+            std::vector<dimension> dimensions(Sid const &sid) {
+                auto &&strides = sid::get_strides(sid);
+                auto &&lower_bounds = sid::get_lower_bounds(sid);
+                auto &&upper_bounds = sid::get_upper_bounds(sid);
+                std::vector<dimension> res;
+                for_each<get_keys<std::decay_t<decltype(upper_bounds)>>>([&](auto key) {
+                    using key_t = decltype(key);
+                    res.push_back({std::ptrdiff_t(at_key<key_t>(upper_bounds) - at_key<key_t>(lower_bounds)),
+                        std::ptrdiff_t(sid::get_stride<key_t>(strides))});
+                });
+                std::stable_sort(res.begin(), res.end(), [](auto const &lhs, auto const &rhs) {
+                    return std::abs(lhs.m_stride) < std::abs(rhs.m_stride);
+                });
+                if (res.empty())
+                    res.push_back({1, 1});
+                return res;
+            }
+
+            template <class Sid>
+            auto origin(Sid const &sid) {
+                auto &&strides = sid::get_strides(sid);
+                auto &&lower_bounds = sid::get_lower_bounds(sid);
+                auto res = sid::get_origin(sid)();
+                for_each<get_keys<std::decay_t<decltype(lower_bounds)>>>([&](auto key) {
+                    using key_t = decltype(key);
+                    sid::shift(res, sid::get_stride<key_t>(strides), at_key<key_t>(lower_bounds));
+                });
+                return res;
+            }
+
+            template <class Sid, class... Fs>
+            auto reduce_many(Sid const &sid, Fs const &... fs) {
+                using ptr_t = sid::ptr_type<Sid>;
+                static_assert(std::is_pointer_v<ptr_t>, "reduce_many requires SIDs with raw pointers");
+                using T = std::remove_cv_t<std::remove_pointer_t<ptr_t>>;
+                constexpr size_t num_functors = sizeof...(Fs);
+                static_assert(num_functors > 0, "no reduction functors given");
+                using is_t = std::make_index_sequence<num_functors>;
+
+                auto functors = tuple<Fs...>(fs...);
+                T const *ptr = origin(sid);
+                auto dims = dimensions(sid);
+                dimension row = dims.front();
+                std::ptrdiff_t segments_per_row = (row.m_size + segment_size - 1) / segment_size;
+                std::ptrdiff_t num_items = segments_per_row;
+                for (size_t d = 1; d != dims.size(); ++d)
+                    num_items *= dims[d].m_size;
+                if (num_items == 0)
+                    throw std::domain_error("reduce_many of an empty SID");
+
+                std::vector<results<T, num_functors>> partials(num_items);
+#pragma omp parallel for schedule(static)
+                for (std::ptrdiff_t item = 0; item < num_items; ++item) {
+                    std::ptrdiff_t segment = item % segments_per_row;
+                    std::ptrdiff_t index = item / segments_per_row;
+                    std::ptrdiff_t offset = segment * segment_size * row.m_stride;
+                    for (size_t d = 1; d != dims.size(); ++d) {
+                        offset += index % dims[d].m_size * dims[d].m_stride;
+                        index /= dims[d].m_size;
+                    }
+                    std::ptrdiff_t n = std::min<std::ptrdiff_t>(segment_size, row.m_size - segment * segment_size);
+                    partials[item] =
+                        row.m_stride == 1
+                            ? reduce_segment(functors, ptr + offset, integral_constant<std::ptrdiff_t, 1>(), n, is_t())
+                            : reduce_segment(functors, ptr + offset, row.m_stride, n, is_t());
+                }
+                return pairwise(functors, partials.data(), num_items, is_t());
+            }
+
+            template <class Sid>
+            auto l2_norm(Sid const &sid) {
+                using std::sqrt;
+                return sqrt(tuple_util::get<0>(reduce_many(sid, sum_sq)));
+            }
+        } // namespace reduce_many_impl_
+
+        using reduce_many_impl_::l2_norm;
+        using reduce_many_impl_::reduce_many;
+    } // namespace reduction
+} // namespace gridtools
@@ -0,0 +1,110 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <type_traits>
+#include <utility>
+
+#include "../common/host_device.hpp"
+#include "concept.hpp"
+#include "delegate.hpp"
+
+namespace gridtools {
+    namespace sid {
+        namespace widen_impl_ {
+            /**
+             *  A reference to a stored element that reads and writes `T`.
+             */
+            template <class Ref, class T>
+            struct narrowing_ref {
+                Ref m_ref;
+
+                GT_FUNCTION operator T() const { return static_cast<T>(m_ref); }
+
+                GT_FUNCTION narrowing_ref const &operator=(T const &val) const {
+                    m_ref = static_cast<std::decay_t<Ref>>(val);
+                    return *this;
+                }
+
+                GT_FUNCTION narrowing_ref const &operator=(narrowing_ref const &other) const {
+                    return *this = static_cast<T>(other);
+                }
+
+                GT_FUNCTION narrowing_ref const &operator+=(T const &val) const { return *this = T(*this) + val; }
+                GT_FUNCTION narrowing_ref const &operator-=(T const &val) const { return *this = T(*this) - val; }
+                GT_FUNCTION narrowing_ref const &operator*=(T const &val) const { return *this = T(*this) * val; }
+                GT_FUNCTION narrowing_ref const &operator/=(T const &val) const { return *this = T(*this) / val; }
+            };
+
+            template <class Ref, class T>
+            GT_FUNCTION std::enable_if_t<!std::is_reference_v<Ref> || std::is_const_v<std::remove_reference_t<Ref>>, T>
+            make_ref(Ref &&ref) {
+                return static_cast<T>(ref);
+            }
+
+            template <class Ref, class T>
+            GT_FUNCTION std::enable_if_t<std::is_reference_v<Ref> && !std::is_const_v<std::remove_reference_t<Ref>>,
+                narrowing_ref<Ref, T>>
+            make_ref(Ref &&ref) {
+                return {ref};
+            }
+
+            template <class Ptr, class T>
+            struct widening_ptr {
+                Ptr m_ptr;
+
+                GT_FUNCTION decltype(auto) operator*() const { return make_ref<decltype(*m_ptr), T>(*m_ptr); }
+
+                template <class Arg>
+                GT_FUNCTION auto operator+=(Arg &&arg) -> decltype(m_ptr += std::forward<Arg>(arg), *this) {
+                    m_ptr += std::forward<Arg>(arg);
+                    return *this;
+                }
+
+                template <class Arg>
+                friend GT_FUNCTION auto operator+(widening_ptr const &obj, Arg &&arg)
+                    -> widening_ptr<decltype(obj.m_ptr + std::forward<Arg>(arg)), T> {
+                    return {obj.m_ptr + std::forward<Arg>(arg)};
+                }
+            };
+
+            template <class Sid, class T>
+            struct widening_adapter : delegate<Sid> {
+                struct widening_ptr_holder {
+                    ptr_holder_type<Sid> m_impl;
+
+                    constexpr GT_FUNCTION widening_ptr<ptr_type<Sid>, T> operator()() const { return {m_impl()}; }
+
+                    friend constexpr GT_FUNCTION widening_ptr_holder operator+(
+                        widening_ptr_holder const &obj, ptr_diff_type<Sid> offset) {
+                        return {obj.m_impl + offset};
+                    }
+                };
+
+                friend widening_ptr_holder sid_get_origin(widening_adapter &obj) { return {get_origin(obj.m_impl)}; }
+                friend ptr_diff_type<Sid> sid_get_ptr_diff(widening_adapter const &) { return {}; }
+                using delegate<Sid>::delegate;
+            };
+        } // namespace widen_impl_
+
+        /**
+         *   Returns a `SID` with the same memory as `src`, which reads (and writes) its elements as `T`. Loads are
+         *   converted to `T` and stores back to the element type of `src`, so that data can be kept in reduced
+         *   precision (for example `float` for a `double` computation) to save memory bandwidth.
+         *
+         *   Dereferencing the pointers gives a value of type `T` if the elements of `src` are const, and a proxy
+         *   reference convertible to and assignable from `T` otherwise.
+         */
+        template <class T, class Src>
+        widen_impl_::widening_adapter<Src, T> widen(Src &&src) {
+            return {std::forward<Src>(src)};
+        }
+    } // namespace sid
+} // namespace gridtools
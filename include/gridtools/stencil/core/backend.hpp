@@ -33,24 +33,67 @@ namespace gridtools {
                         std::move(data_stores));
                 }
 
+                template <class Spec, class Grid>
+                void check_k_sizes(Grid const &grid) {
+#ifndef NDEBUG
+                    for_each<be_api::make_fused_view<Spec>>([&](auto matrix) {
+                        for_each<decltype(matrix)>([&](auto info) {
+                            assert(((void)"domain k-size is too small", grid.k_size(info.interval()) >= 0));
+                        });
+                    });
+#endif
+                }
+
                 template <class Spec>
                 struct call_entry_point_f {
                     template <class Backend, class Grid, class DataStores>
                     void operator()(Backend &&be, Grid const &grid, DataStores data_stores) const {
                         using be_spec_t = convert_fe_to_be_spec<Spec, typename Grid::interval_t, DataStores>;
-#ifndef NDEBUG
-                        for_each<be_api::make_fused_view<be_spec_t>>([&](auto matrix) {
-                            for_each<decltype(matrix)>([&](auto info) {
-                                assert(((void)"domain k-size is too small", grid.k_size(info.interval()) >= 0));
-                            });
-                        });
-#endif
+                        check_k_sizes<be_spec_t>(grid);
                         gridtools_backend_entry_point(
                             std::forward<Backend>(be), be_spec_t(), grid, shift_origin(grid, std::move(data_stores)));
                     }
                 };
+
+                // used for the backends that have no `gridtools_backend_make_plan`: the setup is redone on each call
+                template <class Backend, class Spec, class Grid, class DataStores>
+                class default_plan {
+                    Backend m_backend;
+                    Grid m_grid;
+                    DataStores m_data_stores;
+
+                  public:
+                    default_plan(Backend backend, Grid const &grid, DataStores data_stores)
+                        : m_backend(std::move(backend)), m_grid(grid), m_data_stores(std::move(data_stores)) {}
+
+                    void operator()() const { gridtools_backend_entry_point(m_backend, Spec(), m_grid, m_data_stores); }
+                };
+
+                template <class Backend, class Spec, class Grid, class DataStores>
+                auto make_backend_plan(Backend &&be, Spec, Grid const &grid, DataStores data_stores)
+                    -> decltype(gridtools_backend_make_plan(std::forward<Backend>(be), Spec(), grid, data_stores)) {
+                    return gridtools_backend_make_plan(std::forward<Backend>(be), Spec(), grid, std::move(data_stores));
+                }
+
+                template <class Backend, class Spec, class Grid, class DataStores, class... Ts>
+                default_plan<std::decay_t<Backend>, Spec, Grid, DataStores> make_backend_plan(
+                    Backend &&be, Spec, Grid const &grid, DataStores data_stores, Ts...) {
+                    return {std::forward<Backend>(be), grid, std::move(data_stores)};
+                }
+
+                template <class Spec>
+                struct make_plan_f {
+                    template <class Backend, class Grid, class DataStores>
+                    auto operator()(Backend &&be, Grid const &grid, DataStores data_stores) const {
+                        using be_spec_t = convert_fe_to_be_spec<Spec, typename Grid::interval_t, DataStores>;
+                        check_k_sizes<be_spec_t>(grid);
+                        return make_backend_plan(
+                            std::forward<Backend>(be), be_spec_t(), grid, shift_origin(grid, std::move(data_stores)));
+                    }
+                };
             } // namespace backend_impl_
             using backend_impl_::call_entry_point_f;
+            using backend_impl_::make_plan_f;
         } // namespace core
     }     // namespace stencil
 } // namespace gridtools
@@ -9,10 +9,12 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <type_traits>
 #include <utility>
 
 #include "../../common/defs.hpp"
+#include "../../common/functional.hpp"
 #include "../../common/hymap.hpp"
 #include "../../common/integral_constant.hpp"
 #include "../../common/tuple_util.hpp"
@@ -23,8 +25,10 @@
 #include "../../sid/concept.hpp"
 #include "../../thread_pool/omp.hpp"
 #include "../be_api.hpp"
+#include "../common/caches.hpp"
 #include "../common/dim.hpp"
 #include "execinfo.hpp"
+#include "ij_cache.hpp"
 #include "loops.hpp"
 #include "pos3.hpp"
 #include "tmp_storage_sid.hpp"
@@ -32,26 +36,180 @@
 namespace gridtools {
     namespace stencil {
         namespace cpu_ifirst_backend {
-            template <class ThreadPool = thread_pool::omp>
+            template <class PlhInfo>
+            using is_ij_cached = meta::st_contains<typename PlhInfo::caches_t, cache_type::ij>;
+
+            template <class Matrix>
+            using make_split_view_items =
+                meta::transform<be_api::make_split_view_item, be_api::fuse_stage_rows<Matrix>>;
+
+            // multistages with ij-cached placeholders are executed level by level as a whole, others stage by stage
+            template <class Matrix, class Mss = be_api::make_fused_view_item<Matrix>>
+            using make_view_items = meta::if_<meta::any_of<is_ij_cached, typename Mss::plh_map_t>,
+                meta::list<Mss>,
+                make_split_view_items<Matrix>>;
+
+            template <class Spec>
+            using make_view =
+                meta::rename<be_api::aggregated_view, meta::flatten<meta::transform<make_view_items, Spec>>>;
+
+            template <class PlhInfo>
+            using is_written = std::negation<typename PlhInfo::is_const_t>;
+
+            template <class PlhInfo>
+            using is_written_field = std::conjunction<std::negation<typename PlhInfo::is_tmp_t>, is_written<PlhInfo>>;
+
+            template <class Item>
+            using get_written_plhs =
+                meta::transform<be_api::get_plh, meta::filter<is_written, typename Item::plh_map_t>>;
+
+            template <class Extent>
+            using has_k_extent = std::bool_constant<Extent::kminus::value != 0 || Extent::kplus::value != 0>;
+
+            /*
+             *  The extents of the stages of the backend view are horizontal only. For k-chunked execution the
+             *  levels that a stage has to compute around a chunk are derived like in `compute_extents_metafunctions`:
+             *  the stages are visited backwards, each stage covers the extents with which later stages read its
+             *  outputs, and it extends the extents of its own inputs accordingly.
+             */
+            template <class KExtentMap>
+            struct lookup_k_extent_f {
+                template <class Plh>
+                using apply = meta::rename<enclosing_extent,
+                    meta::pop_front<meta::mp_find<KExtentMap, Plh, meta::list<Plh, extent<>>>>>;
+            };
+
+            template <class KExtentMap>
+            struct get_item_k_extent_f {
+                template <class Item>
+                using apply = meta::rename<enclosing_extent,
+                    meta::push_front<meta::transform<lookup_k_extent_f<KExtentMap>::template apply,
+                                         get_written_plhs<Item>>,
+                        extent<>>>;
+            };
+
+            template <class Extent>
+            struct make_k_extent_item_f {
+                template <class PlhInfo>
+                using apply = meta::list<typename PlhInfo::plh_t, sum_extent<Extent, typename PlhInfo::extent_t>>;
+            };
+
+            template <class KExtentMap, class Item>
+            using add_item_k_extents = meta::foldl<meta::mp_insert,
+                KExtentMap,
+                meta::transform<make_k_extent_item_f<
+                                    typename get_item_k_extent_f<KExtentMap>::template apply<Item>>::template apply,
+                    typename Item::plh_map_t>>;
+
+            template <class Items, class KExtentMap = meta::foldr<add_item_k_extents, meta::list<>, Items>>
+            using get_k_extents = meta::transform<get_item_k_extent_f<KExtentMap>::template apply, Items>;
+
+            /*
+             *  Checks whether the stages of a parallel split view can be executed in k-chunks (see `k_chunked`).
+             *
+             *  Stages with a k-extent are executed twice on the levels around the chunk boundaries. This gives the
+             *  same results only if they write nothing but temporaries that no other stage writes, and do not access
+             *  fields that are written by the computation. Written fields must not be accessed with k-offsets,
+             *  otherwise a stage could see levels of a previous chunk that later stages have already updated.
+             */
+            template <class SplitView>
+            struct can_chunk_k {
+                using items_t = meta::rename<meta::list, SplitView>;
+                using plh_map_t = typename SplitView::plh_map_t;
+                using all_written_plhs_t = meta::flatten<meta::transform<get_written_plhs, items_t>>;
+                using written_fields_t = meta::transform<be_api::get_plh, meta::filter<is_written_field, plh_map_t>>;
+
+                template <class Plh>
+                using is_written_once =
+                    std::bool_constant<meta::length<meta::filter<meta::curry<std::is_same, Plh>::template apply,
+                                           all_written_plhs_t>>::value == 1>;
+
+                template <class PlhInfo>
+                using is_written_field_plh_info = meta::st_contains<written_fields_t, typename PlhInfo::plh_t>;
+
+                template <class Item, class PlhMap = typename Item::plh_map_t>
+                using is_recomputable = std::conjunction<meta::all_of<is_written_once, get_written_plhs<Item>>,
+                    meta::all_of<be_api::get_is_tmp, meta::filter<is_written, PlhMap>>,
+                    std::negation<meta::any_of<is_written_field_plh_info, PlhMap>>>;
+
+                template <class Item, class KExtent>
+                using is_chunkable = std::disjunction<std::negation<has_k_extent<KExtent>>, is_recomputable<Item>>;
+
+                template <class PlhInfo>
+                using is_k_offset_field =
+                    std::conjunction<is_written_field<PlhInfo>, has_k_extent<typename PlhInfo::extent_t>>;
+
+                using type = std::conjunction<meta::all<meta::transform<is_chunkable, items_t, get_k_extents<items_t>>>,
+                    std::negation<meta::any_of<is_k_offset_field, plh_map_t>>>;
+            };
+
+            template <class FuseAll>
+            struct get_caches_f {
+                template <class PlhInfo>
+                using apply = meta::if_<FuseAll, meta::list<>, typename PlhInfo::caches_t>;
+            };
+
+            template <class FuseAll, class TmpPlhMap>
+            using make_tmp_plh_map = be_api::remove_caches_from_plh_map<
+                meta::if_<FuseAll, TmpPlhMap, meta::filter<meta::not_<is_ij_cached>::apply, TmpPlhMap>>>;
+
+            /**
+             * @brief CPU backend that vectorizes along the i-dimension.
+             *
+             * With a `SimdWidth` greater than one, the innermost loop is explicitly strip-mined into packs of that many
+             * i-points, each executed as an `omp simd simdlen(SimdWidth)` loop.
+             */
+            template <class ThreadPool = thread_pool::omp, class SimdWidth = integral_constant<int_t, 1>>
             struct cpu_ifirst {
                 template <class Spec, class Grid, class DataStores>
-                friend void gridtools_backend_entry_point(
+                friend auto gridtools_backend_make_plan(
                     cpu_ifirst, Spec, Grid const &grid, DataStores external_data_stores) {
                     using thread_pool_t = ThreadPool; // workaround needed for nvc++ at least up to 23.3
-                    using stages_t = be_api::make_split_view<Spec>;
+                    using simd_width_t = SimdWidth;
+                    using split_view_t = be_api::make_split_view<Spec>;
                     using all_parrallel_t = typename meta::all_of<be_api::is_parallel,
-                        meta::transform<be_api::get_execution, stages_t>>::type;
+                        meta::transform<be_api::get_execution, split_view_t>>::type;
                     using enclosing_extent_t = meta::rename<enclosing_extent,
-                        meta::transform<be_api::get_extent, typename stages_t::plh_map_t>>;
+                        meta::transform<be_api::get_extent, typename split_view_t::plh_map_t>>;
                     using fuse_all_t =
                         std::bool_constant<all_parrallel_t::value && enclosing_extent_t::kminus::value == 0 &&
                                            enclosing_extent_t::kplus::value == 0>;
+                    using k_chunked_t =
+                        std::bool_constant<all_parrallel_t::value && !fuse_all_t::value &&
+                                           !meta::any_of<is_ij_cached, typename split_view_t::plh_map_t>::value &&
+                                           can_chunk_k<split_view_t>::type::value>;
+                    // if everything is fused, all temporaries are i-j tiles already; ij caches need no special care
+                    using split_t = std::bool_constant<fuse_all_t::value || k_chunked_t::value>;
+                    using stages_t = meta::if_<split_t, split_view_t, make_view<Spec>>;
 
-                    tmp_allocator alloc;
+                    auto make_execinfo = [&grid](int_t block_levels) {
+                        return execinfo(thread_pool_t(), grid, [block_levels](int_t i_block_size, int_t j_block_size) {
+                            return working_set<stages_t>(i_block_size, j_block_size, block_levels);
+                        });
+                    };
+                    execinfo info = make_execinfo(fuse_all_t::value ? 1 : grid.k_size());
 
-                    execinfo info(thread_pool_t(), grid);
+                    auto mode = [&](auto chunked) {
+                        if constexpr (decltype(chunked)::value) {
+                            using k_extent_t =
+                                meta::rename<enclosing_extent, get_k_extents<meta::rename<meta::list, split_view_t>>>;
+                            // the k-axis is only split if the columns of a block do not fit into the cache
+                            bool fits =
+                                working_set<stages_t>(info.i_block_size(), info.j_block_size(), grid.k_size()) <=
+                                hugepage_alloc_impl_::l2_cache_size();
+                            int_t size = k_chunk_size(fits ? grid.k_size() : default_k_chunk_size);
+                            if (size < grid.k_size())
+                                info = make_execinfo(std::min(
+                                    grid.k_size(), size + k_extent_t::kplus::value - k_extent_t::kminus::value));
+                            return k_chunked{size};
+                        } else {
+                            return fuse_all_t();
+                        }
+                    }(k_chunked_t());
+
+                    tmp_allocator alloc;
 
-                    using tmp_plh_map_t = be_api::remove_caches_from_plh_map<typename stages_t::tmp_plh_map_t>;
+                    using tmp_plh_map_t = make_tmp_plh_map<split_t, typename stages_t::tmp_plh_map_t>;
                     auto temporaries = be_api::make_data_stores(tmp_plh_map_t(),
                         [&alloc,
                             block_size = make_pos3(
@@ -72,25 +230,47 @@ namespace gridtools {
 
                     auto data_stores = hymap::concat(std::move(blocked_externals), std::move(temporaries));
 
-                    auto loops = tuple_util::transform(
-                        [&](auto stage) {
-                            using stage_t = decltype(stage);
-                            auto k_sizes = tuple_util::transform(
-                                [&](auto cell) { return grid.k_size(cell.interval()); }, stage_t::cells());
-
-                            using plh_map_t = typename stage_t::plh_map_t;
-                            using keys_t = meta::rename<sid::composite::keys, meta::transform<meta::first, plh_map_t>>;
-                            auto composite = tuple_util::convert_to<keys_t::template values>(tuple_util::transform(
-                                [&](auto info) {
-                                    return sid::add_const(info.is_const(), at_key<decltype(info.plh())>(data_stores));
+                    auto make_loop = [&](auto stage, auto... k_extent) {
+                        using stage_t = decltype(stage);
+                        using plh_map_t = typename stage_t::plh_map_t;
+                        using keys_t = meta::rename<sid::composite::keys, meta::transform<meta::first, plh_map_t>>;
+                        auto composite = tuple_util::convert_to<keys_t::template values>(tuple_util::transform(
+                            overload(
+                                [&, i_block_size = info.i_block_size(), j_block_size = info.j_block_size()](
+                                    meta::list<cache_type::ij>, auto info) {
+                                    return make_ij_cache<decltype(info.data()), decltype(info.extent()), thread_pool_t>(
+                                        alloc, i_block_size, j_block_size);
                                 },
-                                stage_t::plh_map()));
-                            return make_loop<thread_pool_t, stage_t>(
-                                fuse_all_t(), grid, std::move(composite), std::move(k_sizes));
-                        },
-                        meta::rename<tuple, stages_t>());
+                                [&](auto, auto info) {
+                                    return sid::add_const(info.is_const(), at_key<decltype(info.plh())>(data_stores));
+                                }),
+                            meta::transform<get_caches_f<split_t>::template apply, plh_map_t>(),
+                            stage_t::plh_map()));
+                        return make_stage_loop<thread_pool_t, simd_width_t>(
+                            mode, stage, k_extent..., grid, std::move(composite));
+                    };
+
+                    auto loops = [&](auto chunked) {
+                        if constexpr (decltype(chunked)::value)
+                            return tuple_util::transform(make_loop,
+                                meta::rename<tuple, stages_t>(),
+                                meta::rename<tuple, get_k_extents<meta::rename<meta::list, stages_t>>>());
+                        else
+                            return tuple_util::transform(make_loop, meta::rename<tuple, stages_t>());
+                    }(k_chunked_t());
 
-                    run_loops<thread_pool_t>(fuse_all_t(), grid, std::move(loops));
+                    return [alloc = std::move(alloc),
+                               data_stores = std::move(data_stores),
+                               loops = std::move(loops),
+                               info,
+                               grid,
+                               mode] { run_loops<thread_pool_t>(mode, grid, info, loops); };
+                }
+
+                template <class Spec, class Grid, class DataStores>
+                friend void gridtools_backend_entry_point(
+                    cpu_ifirst, Spec, Grid const &grid, DataStores external_data_stores) {
+                    gridtools_backend_make_plan(cpu_ifirst(), Spec(), grid, std::move(external_data_stores))();
                 }
             };
         } // namespace cpu_ifirst_backend
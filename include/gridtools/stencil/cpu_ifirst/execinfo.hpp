@@ -10,9 +10,19 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+
 #include "../../common/defs.hpp"
+#include "../../common/for_each.hpp"
+#include "../../common/hugepage_alloc.hpp"
 #include "../../common/host_device.hpp"
 #include "../../thread_pool/concept.hpp"
+#include "../be_api.hpp"
+#include "../common/dim.hpp"
 
 namespace gridtools {
     namespace stencil {
@@ -40,6 +50,67 @@ namespace gridtools {
                 int_t j_block_size; /** Size of block along j-axis. */
             };
 
+            // stages are executed on whole columns of a block, multistages as a whole level by level (see loops.hpp);
+            // k-serial stages only reuse the previous levels of the current row while sweeping a column, which stay in
+            // the cache for any block size, so a single level is counted for them
+            template <class... Cells>
+            int_t block_levels(be_api::split_view_item<Cells...> stage, int_t k_size) {
+                return be_api::is_parallel<decltype(stage.execution())>::value ? k_size : 1;
+            }
+
+            template <class... IntervalInfos>
+            int_t block_levels(be_api::fused_view_item<IntervalInfos...>, int_t) {
+                return 1;
+            }
+
+            /**
+             * @brief Estimates the number of bytes a block of the largest stage accesses.
+             *
+             * All placeholders of a stage are accounted for with their extents and the number of k-levels of a block
+             * that the stage reuses (at most `k_size`).
+             */
+            template <class Stages>
+            std::size_t working_set(int_t i_block_size, int_t j_block_size, int_t k_size) {
+                std::size_t res = 0;
+                for_each<Stages>([&](auto stage) {
+                    std::size_t levels = block_levels(stage, k_size);
+                    std::size_t bytes = 0;
+                    for_each<typename decltype(stage)::plh_map_t>([&](auto info) {
+                        using info_t = decltype(info);
+                        using extent_t = typename info_t::extent_t;
+                        // the number of colors is only known for temporaries
+                        constexpr std::size_t colors = std::max<int_t>(info_t::num_colors_t::value, 1);
+                        bytes += sizeof(typename info_t::data_t) * colors * extent_t::extend(dim::i(), i_block_size) *
+                                 extent_t::extend(dim::j(), j_block_size);
+                    });
+                    res = std::max(res, levels * bytes);
+                });
+                return res;
+            }
+
+            // number of k-levels of a chunk in k-chunked execution (see loops.hpp) if the columns of a block do not
+            // fit into the cache
+            constexpr int_t default_k_chunk_size = 16;
+
+            /**
+             * @brief Number of k-levels of a chunk in k-chunked execution.
+             *
+             * Returns the value of the environment variable GT_CPU_IFIRST_K_CHUNK_SIZE if set, `size` otherwise.
+             */
+            inline int_t k_chunk_size(int_t size) {
+                const char *env_value = std::getenv("GT_CPU_IFIRST_K_CHUNK_SIZE");
+                if (!env_value)
+                    return size;
+                int res;
+                if (std::sscanf(env_value, "%d", &res) != 1 || res <= 0) {
+                    std::fprintf(stderr,
+                        "warning: env variable GT_CPU_IFIRST_K_CHUNK_SIZE set to invalid value '%s'\n",
+                        env_value);
+                    return size;
+                }
+                return res;
+            }
+
             /**
              * @brief Helper class for block handling.
              */
@@ -48,25 +119,71 @@ namespace gridtools {
                 int_t m_i_block_size, m_j_block_size;
                 int_t m_i_blocks, m_j_blocks;
 
+                // lower limits when shrinking blocks to fit the cache: short rows hurt vectorization and prefetching
+                // much more than thin blocks, so blocks are shrunk along j first
+                static constexpr int_t min_i_block_size = 128;
+                static constexpr int_t min_j_block_size = 2;
+
                 GT_FORCE_INLINE static int_t clamped_block_size(
                     int_t grid_size, int_t block_index, int_t block_size, int_t blocks) {
                     return (block_index == blocks - 1) ? grid_size - block_index * block_size : block_size;
                 }
 
+                bool block_sizes_from_env() {
+                    const char *env_value = std::getenv("GT_CPU_IFIRST_BLOCK_SIZE");
+                    if (!env_value)
+                        return false;
+                    int i_block_size, j_block_size;
+                    if (std::sscanf(env_value, "%dx%d", &i_block_size, &j_block_size) != 2 || i_block_size <= 0 ||
+                        j_block_size <= 0) {
+                        std::fprintf(stderr,
+                            "warning: env variable GT_CPU_IFIRST_BLOCK_SIZE set to invalid value '%s'\n",
+                            env_value);
+                        return false;
+                    }
+                    m_i_block_size = std::min<int_t>(i_block_size, std::max<int_t>(m_i_grid_size, 1));
+                    m_j_block_size = std::min<int_t>(j_block_size, std::max<int_t>(m_j_grid_size, 1));
+                    return true;
+                }
+
               public:
-                template <class ThreadPool, class Grid>
-                GT_FORCE_INLINE execinfo(ThreadPool, const Grid &grid)
+                /**
+                 * @brief Computes the block decomposition of the grid.
+                 *
+                 * The block sizes can be set by the environment variable GT_CPU_IFIRST_BLOCK_SIZE (e.g. `64x8`).
+                 * Otherwise the grid is split among the threads and the blocks are further shrunk until
+                 * `working_set(i_block_size, j_block_size)` fits into the L2 cache. If it does not fit even for the
+                 * smallest blocks, the blocks are not shrunk at all.
+                 */
+                template <class ThreadPool, class Grid, class WorkingSet>
+                execinfo(ThreadPool, const Grid &grid, WorkingSet &&working_set)
                     : m_i_grid_size(grid.i_size()), m_j_grid_size(grid.j_size()) {
-                    int_t threads = thread_pool::get_max_threads(ThreadPool());
+                    if (!block_sizes_from_env()) {
+                        int_t threads = thread_pool::get_max_threads(ThreadPool());
 
-                    // if domain is large enough (relative to the number of threads),
-                    // we split only along j-axis (for prefetching reasons)
-                    // for smaller domains we also split along i-axis
-                    m_j_block_size = (m_j_grid_size + threads - 1) / threads;
-                    m_j_blocks = (m_j_grid_size + m_j_block_size - 1) / m_j_block_size;
-                    int_t max_i_blocks = threads / m_j_blocks;
-                    m_i_block_size = (m_i_grid_size + max_i_blocks - 1) / max_i_blocks;
+                        // if domain is large enough (relative to the number of threads),
+                        // we split only along j-axis (for prefetching reasons)
+                        // for smaller domains we also split along i-axis
+                        m_j_block_size = (m_j_grid_size + threads - 1) / threads;
+                        int_t j_blocks = (m_j_grid_size + m_j_block_size - 1) / m_j_block_size;
+                        int_t max_i_blocks = threads / j_blocks;
+                        m_i_block_size = (m_i_grid_size + max_i_blocks - 1) / max_i_blocks;
+
+                        // if not even the smallest block fits (e.g. whole columns of many fields), shrinking would
+                        // only lose vectorization and add block overhead, so the blocks of the threads are kept
+                        std::size_t cache_size = hugepage_alloc_impl_::l2_cache_size();
+                        if (working_set(std::min(m_i_block_size, min_i_block_size),
+                                std::min(m_j_block_size, min_j_block_size)) > cache_size)
+                            cache_size = std::numeric_limits<std::size_t>::max();
+                        while (m_j_block_size > min_j_block_size &&
+                               working_set(m_i_block_size, m_j_block_size) > cache_size)
+                            m_j_block_size = std::max(min_j_block_size, (m_j_block_size + 1) / 2);
+                        while (m_i_block_size > min_i_block_size &&
+                               working_set(m_i_block_size, m_j_block_size) > cache_size)
+                            m_i_block_size = std::max(min_i_block_size, (m_i_block_size + 1) / 2);
+                    }
                     m_i_blocks = (m_i_grid_size + m_i_block_size - 1) / m_i_block_size;
+                    m_j_blocks = (m_j_grid_size + m_j_block_size - 1) / m_j_block_size;
 
                     assert(m_i_block_size > 0 && m_j_block_size > 0);
                 }
@@ -0,0 +1,39 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cstddef>
+
+#include "../../common/defs.hpp"
+#include "../common/extent.hpp"
+#include "pos3.hpp"
+#include "tmp_storage_sid.hpp"
+
+namespace gridtools {
+    namespace stencil {
+        namespace cpu_ifirst_backend {
+            /**
+             * @brief Per-thread storage for an ij-cached temporary.
+             *
+             * Holds a single k-level of an (extended) i-j block per thread. The storage has no k-stride, so it is
+             * reused for all k-levels of the block. This requires that all stages of a multistage are executed level by
+             * level, see `make_mss_loop`.
+             */
+            template <class T, class Extent, class ThreadPool, class Allocator>
+            auto make_ij_cache(Allocator &allocator, int_t i_block_size, int_t j_block_size) {
+                static_assert(is_extent<Extent>::value, GT_INTERNAL_ERROR);
+                static_assert(Extent::kminus::value == 0 && Extent::kplus::value == 0,
+                    "IJ-cached temporaries can not be accessed with k-offsets.");
+                return make_tmp_storage<T, Extent, true, ThreadPool>(
+                    allocator, make_pos3<std::size_t>(i_block_size, j_block_size, 1));
+            }
+        } // namespace cpu_ifirst_backend
+    }     // namespace stencil
+} // namespace gridtools
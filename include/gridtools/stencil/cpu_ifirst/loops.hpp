@@ -9,16 +9,20 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <type_traits>
 #include <utility>
 
 #include "../../common/defs.hpp"
 #include "../../common/for_each.hpp"
+#include "../../common/integral_constant.hpp"
 #include "../../common/omp.hpp"
 #include "../../common/tuple_util.hpp"
 #include "../../meta.hpp"
+#include "../../sid/blocked_dim.hpp"
 #include "../../sid/concept.hpp"
 #include "../../thread_pool/concept.hpp"
+#include "../be_api.hpp"
 #include "../common/dim.hpp"
 #include "execinfo.hpp"
 
@@ -27,7 +31,8 @@ namespace gridtools {
         namespace cpu_ifirst_backend {
             namespace loops_impl_ {
                 template <class Stage, class Ptr, class Strides>
-                GT_FORCE_INLINE void i_loop(int_t size, Stage stage, Ptr &ptr, Strides const &strides) {
+                GT_FORCE_INLINE void i_loop(
+                    integral_constant<int_t, 1>, int_t size, Stage stage, Ptr &ptr, Strides const &strides) {
 #pragma omp simd
                     for (int_t i = 0; i < size; ++i) {
                         using namespace literals;
@@ -37,7 +42,34 @@ namespace gridtools {
                     sid::shift(ptr, sid::get_stride<dim::i>(strides), -size);
                 }
 
-                template <class Ptr, class Strides>
+                /**
+                 * @brief Strip-mined i-loop for an explicit SIMD width.
+                 *
+                 * The points are processed in packs of `Width` consecutive points, each pack by a SIMD loop with a
+                 * constant trip count and a matching `simdlen`. The points that do not fill a whole pack are computed
+                 * by a scalar remainder loop.
+                 */
+                template <int_t Width, class Stage, class Ptr, class Strides>
+                GT_FORCE_INLINE void i_loop(
+                    integral_constant<int_t, Width>, int_t size, Stage stage, Ptr &ptr, Strides const &strides) {
+                    using namespace literals;
+                    auto &&i_stride = sid::get_stride<dim::i>(strides);
+                    int_t i = 0;
+                    for (; i + Width <= size; i += Width) {
+#pragma omp simd simdlen(Width)
+                        for (int_t lane = 0; lane < Width; ++lane) {
+                            stage(ptr, strides);
+                            sid::shift(ptr, i_stride, 1_c);
+                        }
+                    }
+                    for (; i < size; ++i) {
+                        stage(ptr, strides);
+                        sid::shift(ptr, i_stride, 1_c);
+                    }
+                    sid::shift(ptr, i_stride, -size);
+                }
+
+                template <class SimdWidth, class Ptr, class Strides>
                 struct k_i_loops_f {
                     int_t m_i_size;
                     Ptr &m_ptr;
@@ -46,19 +78,19 @@ namespace gridtools {
                     template <class Cell, class KSize>
                     GT_FORCE_INLINE void operator()(Cell cell, KSize k_size) const {
                         for (int_t k = 0; k < k_size; ++k) {
-                            i_loop(m_i_size, cell, m_ptr, m_strides);
+                            i_loop(SimdWidth(), m_i_size, cell, m_ptr, m_strides);
                             cell.inc_k(m_ptr, m_strides);
                         }
                     }
                 };
 
-                template <class Ptr, class Strides>
-                GT_FORCE_INLINE k_i_loops_f<Ptr, Strides> make_k_i_loops(
+                template <class SimdWidth, class Ptr, class Strides>
+                GT_FORCE_INLINE k_i_loops_f<SimdWidth, Ptr, Strides> make_k_i_loops(
                     int_t i_size, Ptr &ptr, Strides const &strides) {
                     return {i_size, ptr, strides};
                 }
 
-                template <class ThreadPool, class Stage, class Grid, class Composite, class KSizes>
+                template <class ThreadPool, class SimdWidth, class Stage, class Grid, class Composite, class KSizes>
                 auto make_loop(std::true_type, Grid const &grid, Composite composite, KSizes k_sizes) {
                     using extent_t = typename Stage::extent_t;
                     using ptr_diff_t = sid::ptr_diff_type<Composite>;
@@ -87,7 +119,7 @@ namespace gridtools {
                             tuple_util::for_each(
                                 [&ptr, &strides, &cur, k = info.k, i_size](auto cell, auto k_size) {
                                     if (k >= cur && k < cur + k_size)
-                                        i_loop(i_size, cell, ptr, strides);
+                                        i_loop(SimdWidth(), i_size, cell, ptr, strides);
                                     cur += k_size;
                                 },
                                 Stage::cells(),
@@ -98,8 +130,7 @@ namespace gridtools {
                 }
 
                 template <class ThreadPool, class Grid, class Loops>
-                void run_loops(std::true_type, Grid const &grid, Loops loops) {
-                    execinfo info(ThreadPool(), grid);
+                void run_loops(std::true_type, Grid const &grid, execinfo const &info, Loops const &loops) {
                     int_t i_blocks = info.i_blocks();
                     int_t j_blocks = info.j_blocks();
                     int_t k_size = grid.k_size();
@@ -113,7 +144,7 @@ namespace gridtools {
                         j_blocks);
                 }
 
-                template <class ThreadPool, class Stage, class Grid, class Composite, class KSizes>
+                template <class ThreadPool, class SimdWidth, class Stage, class Grid, class Composite, class KSizes>
                 auto make_loop(std::false_type, Grid const &grid, Composite composite, KSizes k_sizes) {
                     using extent_t = typename Stage::extent_t;
                     using ptr_diff_t = sid::ptr_diff_type<Composite>;
@@ -139,7 +170,7 @@ namespace gridtools {
                         int_t j_size = extent_t::extend(dim::j(), info.j_block_size);
                         int_t i_size = extent_t::extend(dim::i(), info.i_block_size);
 
-                        auto k_i_loops = make_k_i_loops(i_size, ptr, strides);
+                        auto k_i_loops = make_k_i_loops<SimdWidth>(i_size, ptr, strides);
                         for (int_t j = 0; j < j_size; ++j) {
                             using namespace literals;
                             tuple_util::for_each(k_i_loops, Stage::cells(), k_sizes);
@@ -149,9 +180,161 @@ namespace gridtools {
                     };
                 }
 
+                template <class SimdWidth, class Cell, class Ptr, class Strides>
+                GT_FORCE_INLINE void j_i_loops(
+                    Cell cell, Ptr ptr, Strides const &strides, int_t i_block_size, int_t j_block_size) {
+                    using namespace literals;
+                    using extent_t = typename Cell::extent_t;
+                    sid::shift(ptr, sid::get_stride<dim::i>(strides), extent_t::minus(dim::i()));
+                    sid::shift(ptr, sid::get_stride<dim::j>(strides), extent_t::minus(dim::j()));
+                    int_t j_size = extent_t::extend(dim::j(), j_block_size);
+                    int_t i_size = extent_t::extend(dim::i(), i_block_size);
+                    for (int_t j = 0; j < j_size; ++j) {
+                        i_loop(SimdWidth(), i_size, cell, ptr, strides);
+                        sid::shift(ptr, sid::get_stride<dim::j>(strides), 1_c);
+                    }
+                }
+
+                /**
+                 * @brief Loop over a whole multistage, executing all its stages level by level.
+                 *
+                 * In contrast to the stage-wise loops above, each k-level of a block is completed by all stages before
+                 * proceeding to the next one. Data written and read at the same k-level thus only needs to live for a
+                 * single level, which allows ij-cached temporaries to be backed by a single i-j tile per thread.
+                 */
+                template <class ThreadPool, class SimdWidth, class Mss, class Grid, class Composite>
+                auto make_mss_loop(Grid const &grid, Composite composite) {
+                    using ptr_diff_t = sid::ptr_diff_type<Composite>;
+
+                    auto strides = sid::get_strides(composite);
+                    ptr_diff_t offset{};
+                    sid::shift(
+                        offset, sid::get_stride<dim::k>(strides), grid.k_start(Mss::interval(), Mss::execution()));
+                    auto k_sizes = tuple_util::transform(
+                        [&](auto interval_info) { return grid.k_size(interval_info.interval()); },
+                        Mss::interval_infos());
+
+                    return [origin = sid::get_origin(composite) + offset,
+                               strides = std::move(strides),
+                               k_sizes = std::move(k_sizes)](execinfo_block_kserial const &info) {
+                        ptr_diff_t offset{};
+                        sid::shift(
+                            offset, sid::get_stride<dim::thread>(strides), thread_pool::get_thread_num(ThreadPool()));
+                        sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::i>>(strides), info.i_block);
+                        sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::j>>(strides), info.j_block);
+                        auto ptr = origin() + offset;
+
+                        tuple_util::for_each(
+                            [&](auto interval_info, auto k_size) {
+                                for (int_t k = 0; k < k_size; ++k) {
+                                    tuple_util::for_each(
+                                        [&](auto cell) {
+                                            j_i_loops<SimdWidth>(
+                                                cell, ptr, strides, info.i_block_size, info.j_block_size);
+                                        },
+                                        interval_info.cells());
+                                    interval_info.inc_k(ptr, strides);
+                                }
+                            },
+                            Mss::interval_infos(),
+                            k_sizes);
+                    };
+                }
+
+                template <class ThreadPool, class SimdWidth, class FuseAll, class... Cells, class Grid, class Composite>
+                auto make_stage_loop(
+                    FuseAll, be_api::split_view_item<Cells...> stage, Grid const &grid, Composite composite) {
+                    auto k_sizes =
+                        tuple_util::transform([&](auto cell) { return grid.k_size(cell.interval()); }, stage.cells());
+                    return make_loop<ThreadPool, SimdWidth, decltype(stage)>(
+                        FuseAll(), grid, std::move(composite), std::move(k_sizes));
+                }
+
+                /**
+                 * @brief Execution mode of parallel stages that splits the k-axis into chunks of `size` levels.
+                 *
+                 * All stages of a block are executed on one chunk before proceeding to the next chunk, so that the
+                 * temporaries of a block are only touched on the levels of a chunk. Stages with a k-extent are
+                 * additionally executed on the levels around the chunk that are read by later stages; those levels are
+                 * thus computed again with the neighbouring chunk.
+                 */
+                struct k_chunked {
+                    int_t size;
+                };
+
+                /**
+                 * @brief Loop over a stage in k-chunked execution.
+                 *
+                 * `KExtent` holds the k-levels around a chunk that later stages read from the outputs of the stage.
+                 */
+                template <class ThreadPool, class SimdWidth, class... Cells, class KExtent, class Grid, class Composite>
+                auto make_stage_loop(k_chunked,
+                    be_api::split_view_item<Cells...> stage,
+                    KExtent,
+                    Grid const &grid,
+                    Composite composite) {
+                    using stage_t = decltype(stage);
+                    using extent_t = typename stage_t::extent_t;
+                    using ptr_diff_t = sid::ptr_diff_type<Composite>;
+
+                    auto strides = sid::get_strides(composite);
+                    ptr_diff_t offset{};
+                    sid::shift(offset, sid::get_stride<dim::i>(strides), extent_t::minus(dim::i()));
+                    sid::shift(offset, sid::get_stride<dim::j>(strides), extent_t::minus(dim::j()));
+                    auto k_sizes =
+                        tuple_util::transform([&](auto cell) { return grid.k_size(cell.interval()); }, stage.cells());
+                    int_t k_start = grid.k_start(stage.interval());
+
+                    return [origin = sid::get_origin(composite) + offset,
+                               strides = std::move(strides),
+                               k_start,
+                               k_end = k_start + grid.k_size(stage.interval()),
+                               k_sizes = std::move(k_sizes)](
+                               execinfo_block_kserial const &info, int_t chunk_begin, int_t chunk_end) {
+                        int_t begin = std::max(k_start, chunk_begin + KExtent::kminus::value);
+                        int_t end = std::min(k_end, chunk_end + KExtent::kplus::value);
+                        if (begin >= end)
+                            return;
+
+                        ptr_diff_t offset{};
+                        sid::shift(
+                            offset, sid::get_stride<dim::thread>(strides), thread_pool::get_thread_num(ThreadPool()));
+                        sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::i>>(strides), info.i_block);
+                        sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::j>>(strides), info.j_block);
+                        sid::shift(offset, sid::get_stride<dim::k>(strides), begin);
+                        auto ptr = origin() + offset;
+
+                        int_t j_size = extent_t::extend(dim::j(), info.j_block_size);
+                        int_t i_size = extent_t::extend(dim::i(), info.i_block_size);
+
+                        for (int_t j = 0; j < j_size; ++j) {
+                            using namespace literals;
+                            int_t cur = k_start;
+                            tuple_util::for_each(
+                                [&](auto cell, auto k_size) {
+                                    for (int_t k = std::max(cur, begin); k < std::min(cur + k_size, end); ++k) {
+                                        i_loop(SimdWidth(), i_size, cell, ptr, strides);
+                                        sid::shift(ptr, sid::get_stride<dim::k>(strides), 1_c);
+                                    }
+                                    cur += k_size;
+                                },
+                                stage_t::cells(),
+                                k_sizes);
+                            sid::shift(ptr, sid::get_stride<dim::k>(strides), begin - end);
+                            sid::shift(ptr, sid::get_stride<dim::j>(strides), 1_c);
+                        }
+                    };
+                }
+
+                template <class ThreadPool, class SimdWidth, class... IntervalInfos, class Grid, class Composite>
+                auto make_stage_loop(
+                    std::false_type, be_api::fused_view_item<IntervalInfos...>, Grid const &grid, Composite composite) {
+                    return make_mss_loop<ThreadPool, SimdWidth, be_api::fused_view_item<IntervalInfos...>>(
+                        grid, std::move(composite));
+                }
+
                 template <class ThreadPool, class Grid, class Loops>
-                void run_loops(std::false_type, Grid const &grid, Loops loops) {
-                    execinfo info(ThreadPool(), grid);
+                void run_loops(std::false_type, Grid const &, execinfo const &info, Loops const &loops) {
                     thread_pool::parallel_for_loop(
                         ThreadPool(),
                         [&](auto i, auto j) {
@@ -160,8 +343,27 @@ namespace gridtools {
                         info.i_blocks(),
                         info.j_blocks());
                 }
+
+                template <class ThreadPool, class Grid, class Loops>
+                void run_loops(k_chunked chunk, Grid const &grid, execinfo const &info, Loops const &loops) {
+                    int_t k_size = grid.k_size();
+                    thread_pool::parallel_for_loop(
+                        ThreadPool(),
+                        [&](auto i, auto j) {
+                            auto block = info.block(i, j);
+                            for (int_t k = 0; k < k_size; k += chunk.size) {
+                                int_t k_end = std::min(k + chunk.size, k_size);
+                                tuple_util::for_each([&](auto &&loop) { loop(block, k, k_end); }, loops);
+                            }
+                        },
+                        info.i_blocks(),
+                        info.j_blocks());
+                }
             } // namespace loops_impl_
+            using loops_impl_::k_chunked;
             using loops_impl_::make_loop;
+            using loops_impl_::make_mss_loop;
+            using loops_impl_::make_stage_loop;
             using loops_impl_::run_loops;
         } // namespace cpu_ifirst_backend
     }     // namespace stencil
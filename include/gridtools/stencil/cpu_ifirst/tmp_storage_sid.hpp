@@ -63,14 +63,15 @@ namespace gridtools {
                     return bs.i * bs.j * bs.k * thread_pool::get_max_threads(ThreadPool()) + extra;
                 }
 
-                template <std::size_t, class>
+                template <std::size_t, class, bool>
                 struct strides_kind_impl {};
 
                 /**
-                 * @brief Strides kind tag. Strides depend on data type size (due to cache-line alignment) and extent.
+                 * @brief Strides kind tag. Strides depend on data type size (due to cache-line alignment), extent and
+                 * the presence of a k-stride.
                  */
-                template <class T, class Extent>
-                using strides_kind = strides_kind_impl<sizeof(T), Extent>;
+                template <class T, class Extent, bool AllParallel>
+                using strides_kind = strides_kind_impl<sizeof(T), Extent, AllParallel>;
 
                 /**
                  * @brief Strides, depending on data type due to padding to cache-line size. Specialization for non-zero
@@ -135,7 +136,7 @@ namespace gridtools {
                                                     _impl_tmp::storage_size<T, Extent, ThreadPool>(block_size)) +
                                                 _impl_tmp::origin_offset<T, Extent, AllParallel>(block_size))
                     .template set<sid::property::strides>(_impl_tmp::strides<T, Extent, AllParallel>(block_size))
-                    .template set<sid::property::strides_kind, _impl_tmp::strides_kind<T, Extent>>()
+                    .template set<sid::property::strides_kind, _impl_tmp::strides_kind<T, Extent, AllParallel>>()
                     .template set<sid::property::ptr_diff, int_t>();
             }
         } // namespace cpu_ifirst_backend
@@ -9,12 +9,17 @@
  */
 #pragma once
 
+#include <cassert>
+#include <chrono>
 #include <memory>
+#include <type_traits>
 #include <utility>
 
 #include "../common/defs.hpp"
 #include "../common/for_each.hpp"
+#include "../common/functional.hpp"
 #include "../common/host_device.hpp"
+#include "../common/hymap.hpp"
 #include "../common/integral_constant.hpp"
 #include "../common/tuple.hpp"
 #include "../common/tuple_util.hpp"
@@ -30,7 +35,11 @@
 #include "../thread_pool/concept.hpp"
 #include "../thread_pool/omp.hpp"
 #include "be_api.hpp"
+#include "common/caches.hpp"
 #include "common/dim.hpp"
+#include "cpu_kfirst/k_cache.hpp"
+#include "cpu_kfirst/tuning_cache.hpp"
+#include "fill_flush.hpp"
 
 namespace gridtools {
     namespace stencil {
@@ -85,45 +94,144 @@ namespace gridtools {
                 };
             }
 
-            template <class IBlockSize = integral_constant<int_t, 8>,
-                class JBlockSize = integral_constant<int_t, 8>,
-                class ThreadPool = thread_pool::omp>
-            struct cpu_kfirst {};
+            template <class Extent>
+            GT_FORCE_INLINE bool is_in_extent(Extent, int_t i, int_t j, int_t i_size, int_t j_size) {
+                return i >= Extent::iminus::value && i < i_size + Extent::iplus::value && j >= Extent::jminus::value &&
+                       j < j_size + Extent::jplus::value;
+            }
 
-            template <class IBlockSize, class JBlockSize, class ThreadPool, class Spec, class Grid, class DataStores>
-            void gridtools_backend_entry_point(cpu_kfirst<IBlockSize, JBlockSize, ThreadPool>,
-                Spec,
-                Grid const &grid,
-                DataStores external_data_stores) {
-                using stages_t = be_api::make_split_view<Spec>;
+            // a multistage with k-caches is executed column by column: all its stages are applied to a k-level before
+            // going to the next one, so that the k-cached values can be kept in a small per-column window
+            template <class ThreadPool, class... IntervalInfos, class Grid, class DataStores>
+            auto make_stage_loop(
+                ThreadPool, be_api::fused_view_item<IntervalInfos...> mss, Grid const &grid, DataStores &data_stores) {
+                using mss_t = decltype(mss);
+                using extent_t = typename mss_t::extent_t;
+
+                using plh_map_t = typename mss_t::plh_map_t;
+                using keys_t = meta::rename<sid::composite::keys, meta::transform<meta::first, plh_map_t>>;
+                auto composite = tuple_util::convert_to<keys_t::template values>(tuple_util::transform(
+                    overload([](meta::list<cache_type::k>, auto) { return k_cache_sid_t(); },
+                        [&](auto, auto info) {
+                            return sid::add_const(info.is_const(), at_key<decltype(info.plh())>(data_stores));
+                        }),
+                    meta::transform<be_api::get_caches, plh_map_t>(),
+                    plh_map_t()));
+                using ptr_diff_t = sid::ptr_diff_type<decltype(composite)>;
+
+                auto strides = sid::get_strides(composite);
+                ptr_diff_t offset{};
+                sid::shift(offset, sid::get_stride<dim::i>(strides), extent_t::minus(dim::i()));
+                sid::shift(offset, sid::get_stride<dim::j>(strides), extent_t::minus(dim::j()));
+                sid::shift(offset, sid::get_stride<dim::k>(strides), grid.k_start(mss.interval(), mss.execution()));
+
+                return [origin = sid::get_origin(composite) + offset,
+                           strides = std::move(strides),
+                           k_sizes = be_api::make_k_sizes(mss.interval_infos(), grid)](
+                           int_t i_block, int_t j_block, int_t i_size, int_t j_size) {
+                    ptr_diff_t offset{};
+                    sid::shift(
+                        offset, sid::get_stride<dim::thread>(strides), thread_pool::get_thread_num(ThreadPool()));
+                    sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::i>>(strides), i_block);
+                    sid::shift(offset, sid::get_stride<sid::blocked_dim<dim::j>>(strides), j_block);
+                    auto ptr = origin() + offset;
+                    int_t i_end = i_size + extent_t::iplus::value;
+                    int_t j_end = j_size + extent_t::jplus::value;
+                    for (int_t i = extent_t::iminus::value; i < i_end; ++i) {
+                        for (int_t j = extent_t::jminus::value; j < j_end; ++j) {
+                            k_caches_type<mss_t> k_caches;
+                            auto mixed_ptr = hymap::merge(k_caches.ptr(), ptr);
+                            tuple_util::for_each(
+                                [&](int_t size, auto info) GT_FORCE_INLINE_LAMBDA {
+                                    for (int_t k = 0; k < size; ++k) {
+                                        for_each<typename decltype(info)::cells_t>([&](auto cell)
+                                                                                       GT_FORCE_INLINE_LAMBDA {
+                                            if (is_in_extent(cell.extent(), i, j, i_size, j_size))
+                                                cell(mixed_ptr, strides);
+                                        });
+                                        k_caches.slide(info.k_step());
+                                        info.inc_k(mixed_ptr.secondary(), strides);
+                                    }
+                                },
+                                k_sizes,
+                                mss_t::interval_infos());
+                            sid::shift(ptr, sid::get_stride<dim::j>(strides), integral_constant<int_t, 1>());
+                        }
+                        sid::shift(ptr, sid::get_stride<dim::j>(strides), extent_t::jminus::value - j_end);
+                        sid::shift(ptr, sid::get_stride<dim::i>(strides), integral_constant<int_t, 1>());
+                    }
+                };
+            }
+
+            template <class Matrix>
+            using make_split_view_items =
+                meta::transform<be_api::make_split_view_item, be_api::fuse_stage_rows<Matrix>>;
+
+            template <class Row>
+            using row_needs_sync = typename meta::first<Row>::need_sync_t;
+
+            // k-caches are used if the stages of a sequential multistage can be applied column by column, i.e. no
+            // stage reads the output of a preceding one with horizontal offsets
+            template <class Matrix, class Mss = be_api::make_fused_view_item<fill_flush::transform_mss<Matrix>>>
+            using make_view_items = meta::if_c<!be_api::is_parallel<typename Mss::execution_t>::value &&
+                                                   meta::any_of<is_k_cached, typename Mss::plh_map_t>::value &&
+                                                   !meta::any_of<row_needs_sync, meta::pop_front<Matrix>>::value,
+                meta::list<Mss>,
+                make_split_view_items<Matrix>>;
+
+            template <class Spec>
+            using make_view =
+                meta::rename<be_api::aggregated_view, meta::flatten<meta::transform<make_view_items, Spec>>>;
+
+            template <class Item>
+            struct get_storage_plh_map {
+                using type = typename Item::plh_map_t;
+            };
+
+            template <class... IntervalInfos>
+            struct get_storage_plh_map<be_api::fused_view_item<IntervalInfos...>> {
+                using type = meta::filter<meta::not_<is_k_cached>::apply,
+                    typename be_api::fused_view_item<IntervalInfos...>::plh_map_t>;
+            };
+
+            template <class Items>
+            using make_tmp_plh_map = be_api::remove_caches_from_plh_map<meta::filter<be_api::get_is_tmp,
+                meta::rename<be_api::merge_plh_maps, meta::transform<meta::force<get_storage_plh_map>::apply, Items>>>>;
+
+            template <class ThreadPool, class Spec, class IBlockSize, class JBlockSize, class Grid, class DataStores>
+            auto make_executor(
+                IBlockSize i_block_size, JBlockSize j_block_size, Grid const &grid, DataStores external_data_stores) {
+                using stages_t = make_view<Spec>;
 
                 auto alloc = sid::cached_allocator(&std::make_unique<char[]>);
 
-                using tmp_plh_map_t = be_api::remove_caches_from_plh_map<typename stages_t::tmp_plh_map_t>;
-                auto temporaries = be_api::make_data_stores(tmp_plh_map_t(), [&grid, &alloc](auto info) {
-                    auto extent = info.extent();
-                    auto interval = stages_t::interval();
-                    auto num_colors = info.num_colors();
-                    auto offsets = hymap::keys<dim::i, dim::j, dim::k>::make_values(-extent.minus(dim::i()),
-                        -extent.minus(dim::j()),
-                        -grid.k_start(interval) - extent.minus(dim::k()));
-                    auto sizes = hymap::keys<dim::c, dim::k, dim::j, dim::i, dim::thread>::make_values(num_colors,
-                        grid.k_size(interval, extent),
-                        extent.extend(dim::j(), JBlockSize()),
-                        extent.extend(dim::i(), IBlockSize()),
-                        thread_pool::get_max_threads(ThreadPool()));
-
-                    using stride_kind = meta::list<decltype(extent), decltype(num_colors)>;
-                    return sid::shift_sid_origin(
-                        sid::make_contiguous<decltype(info.data()), int_t, stride_kind>(alloc, sizes), offsets);
-                });
+                using tmp_plh_map_t = make_tmp_plh_map<stages_t>;
+                auto temporaries =
+                    be_api::make_data_stores(tmp_plh_map_t(), [&grid, &alloc, i_block_size, j_block_size](auto info) {
+                        auto extent = info.extent();
+                        auto interval = stages_t::interval();
+                        auto num_colors = info.num_colors();
+                        auto offsets = hymap::keys<dim::i, dim::j, dim::k>::make_values(-extent.minus(dim::i()),
+                            -extent.minus(dim::j()),
+                            -grid.k_start(interval) - extent.minus(dim::k()));
+                        auto sizes = hymap::keys<dim::c, dim::k, dim::j, dim::i, dim::thread>::make_values(num_colors,
+                            grid.k_size(interval, extent),
+                            extent.extend(dim::j(), j_block_size),
+                            extent.extend(dim::i(), i_block_size),
+                            thread_pool::get_max_threads(ThreadPool()));
+
+                        using stride_kind = meta::list<decltype(extent), decltype(num_colors)>;
+                        return sid::shift_sid_origin(
+                            sid::make_contiguous<decltype(info.data()), int_t, stride_kind>(alloc, sizes), offsets);
+                    });
 
+                assert(fill_flush::validate_k_bounds<Spec>(grid, external_data_stores));
                 auto blocked_external_data_stores = tuple_util::transform(
-                    [&](auto &&data_store) GT_FORCE_INLINE_LAMBDA {
-                        return sid::block(std::forward<decltype(data_store)>(data_store),
-                            hymap::keys<dim::i, dim::j>::values<IBlockSize, JBlockSize>());
+                    [block_sizes = hymap::keys<dim::i, dim::j>::make_values(i_block_size, j_block_size)](
+                        auto &&data_store) GT_FORCE_INLINE_LAMBDA {
+                        return sid::block(std::forward<decltype(data_store)>(data_store), block_sizes);
                     },
-                    std::move(external_data_stores));
+                    fill_flush::transform_data_stores<typename stages_t::plh_map_t>(std::move(external_data_stores)));
 
                 auto data_stores = hymap::concat(std::move(blocked_external_data_stores), std::move(temporaries));
 
@@ -135,21 +243,83 @@ namespace gridtools {
                 int_t total_i = grid.i_size();
                 int_t total_j = grid.j_size();
 
-                int_t NBI = (total_i + IBlockSize::value - 1) / IBlockSize::value;
-                int_t NBJ = (total_j + JBlockSize::value - 1) / JBlockSize::value;
+                return [alloc = std::move(alloc),
+                           data_stores = std::move(data_stores),
+                           stage_loops = std::move(stage_loops),
+                           total_i,
+                           total_j,
+                           i_block_size,
+                           j_block_size] {
+                    int_t NBI = (total_i + i_block_size - 1) / i_block_size;
+                    int_t NBJ = (total_j + j_block_size - 1) / j_block_size;
 
-                thread_pool::parallel_for_loop(
-                    ThreadPool(),
-                    [&](auto bj, auto bi) {
-                        int_t i_size = bi + 1 == NBI ? total_i - bi * IBlockSize::value : IBlockSize::value;
-                        int_t j_size = bj + 1 == NBJ ? total_j - bj * JBlockSize::value : JBlockSize::value;
-                        tuple_util::for_each(
-                            [=](auto &&fun) GT_FORCE_INLINE_LAMBDA { fun(bi, bj, i_size, j_size); }, stage_loops);
-                    },
-                    NBJ,
-                    NBI);
+                    thread_pool::parallel_for_loop(
+                        ThreadPool(),
+                        [&](auto bj, auto bi) {
+                            int_t i_size = bi + 1 == NBI ? total_i - bi * i_block_size : i_block_size;
+                            int_t j_size = bj + 1 == NBJ ? total_j - bj * j_block_size : j_block_size;
+                            tuple_util::for_each(
+                                [=](auto &&fun) GT_FORCE_INLINE_LAMBDA { fun(bi, bj, i_size, j_size); }, stage_loops);
+                        },
+                        NBJ,
+                        NBI);
+                };
+            }
+
+            template <class ThreadPool, class Spec, class IBlockSize, class JBlockSize, class Grid, class DataStores>
+            void entry_point(
+                IBlockSize i_block_size, JBlockSize j_block_size, Grid const &grid, DataStores external_data_stores) {
+                make_executor<ThreadPool, Spec>(i_block_size, j_block_size, grid, std::move(external_data_stores))();
+            }
+
+            template <class IBlockSize = integral_constant<int_t, 8>,
+                class JBlockSize = integral_constant<int_t, 8>,
+                class ThreadPool = thread_pool::omp>
+            struct cpu_kfirst {};
+
+            template <class IBlockSize, class JBlockSize, class ThreadPool, class Spec, class Grid, class DataStores>
+            void gridtools_backend_entry_point(cpu_kfirst<IBlockSize, JBlockSize, ThreadPool>,
+                Spec,
+                Grid const &grid,
+                DataStores external_data_stores) {
+                entry_point<ThreadPool, Spec>(IBlockSize(), JBlockSize(), grid, std::move(external_data_stores));
+            }
+
+            template <class IBlockSize, class JBlockSize, class ThreadPool, class Spec, class Grid, class DataStores>
+            auto gridtools_backend_make_plan(cpu_kfirst<IBlockSize, JBlockSize, ThreadPool>,
+                Spec,
+                Grid const &grid,
+                DataStores external_data_stores) {
+                return make_executor<ThreadPool, Spec>(
+                    IBlockSize(), JBlockSize(), grid, std::move(external_data_stores));
+            }
+
+            /**
+             * @brief `cpu_kfirst` with block sizes that are tuned at runtime.
+             *
+             * The first calls for a given spec, domain size and number of threads are each run with one of a set of
+             * candidate block sizes and timed. Once all candidates are measured, the fastest one is used for all
+             * subsequent calls and stored in the tuning cache (see `tuning_cache`). The value types of the fields are
+             * part of the tuning key.
+             */
+            template <class ThreadPool = thread_pool::omp>
+            struct cpu_kfirst_autotuned {};
+
+            template <class ThreadPool, class Spec, class Grid, class DataStores>
+            void gridtools_backend_entry_point(
+                cpu_kfirst_autotuned<ThreadPool>, Spec, Grid const &grid, DataStores external_data_stores) {
+                auto &cache = tuning_cache::instance();
+                using value_types_t = meta::transform<sid::element_type, tuple_util::traits::to_types<DataStores>>;
+                auto key = make_tuning_key<Spec, value_types_t>(
+                    grid.i_size(), grid.j_size(), grid.k_size(), thread_pool::get_max_threads(ThreadPool()));
+                auto [sizes, candidate] = cache.get(key);
+                auto start = std::chrono::steady_clock::now();
+                entry_point<ThreadPool, Spec>(sizes.i, sizes.j, grid, std::move(external_data_stores));
+                std::chrono::duration<double> time = std::chrono::steady_clock::now() - start;
+                cache.report(key, candidate, time.count());
             }
         } // namespace cpu_kfirst_backend
         using cpu_kfirst_backend::cpu_kfirst;
+        using cpu_kfirst_backend::cpu_kfirst_autotuned;
     } // namespace stencil
 } // namespace gridtools
@@ -0,0 +1,199 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+#include <tuple>
+#include <typeinfo>
+#include <utility>
+#include <vector>
+
+#include <sys/file.h>
+
+#include "../../common/defs.hpp"
+
+namespace gridtools {
+    namespace stencil {
+        namespace cpu_kfirst_backend {
+            namespace tuning_cache_impl_ {
+                struct block_sizes {
+                    int_t i;
+                    int_t j;
+                };
+
+                // the default block size comes first, so the first measured run is as fast as an untuned one
+                inline std::vector<block_sizes> const &candidates() {
+                    static const std::vector<block_sizes> res = {
+                        {8, 8}, {16, 8}, {32, 8}, {16, 16}, {64, 4}, {32, 16}, {128, 2}};
+                    return res;
+                }
+
+                // number of measurements per candidate, the minimum time is used
+                constexpr std::size_t rounds = 2;
+
+                // FNV-1a, the tuning keys have to be stable across runs
+                inline std::uint64_t hash(char const *str, std::uint64_t res = 14695981039346656037ull) {
+                    for (; *str; ++str)
+                        res = (res ^ (unsigned char)*str) * 1099511628211ull;
+                    return res;
+                }
+
+                using tuning_key_t = std::tuple<std::uint64_t, int_t, int_t, int_t, int_t>;
+
+                // `ValueTypes` is the list of the value types of the fields, the same spec may run at another speed
+                // in single precision
+                template <class Spec, class ValueTypes>
+                tuning_key_t make_tuning_key(int_t i_size, int_t j_size, int_t k_size, int_t num_threads) {
+                    return {hash(typeid(ValueTypes).name(), hash(typeid(Spec).name())),
+                        i_size,
+                        j_size,
+                        k_size,
+                        num_threads};
+                }
+
+                // an open file with an flock held for its lifetime, so that concurrent processes sharing the tuning
+                // cache file never see partially written lines
+                class locked_file {
+                    std::FILE *m_fp;
+
+                  public:
+                    locked_file(std::string const &name, char const *mode, int operation)
+                        : m_fp(std::fopen(name.c_str(), mode)) {
+                        if (m_fp)
+                            flock(fileno(m_fp), operation);
+                    }
+                    locked_file(locked_file const &) = delete;
+                    locked_file &operator=(locked_file const &) = delete;
+                    ~locked_file() {
+                        if (!m_fp)
+                            return;
+                        std::fflush(m_fp);
+                        flock(fileno(m_fp), LOCK_UN);
+                        std::fclose(m_fp);
+                    }
+
+                    std::FILE *get() const { return m_fp; }
+                };
+
+                /**
+                 * @brief Store of the tuned block sizes.
+                 *
+                 * If a file is given, the tuned block sizes are read from it on construction and new results are
+                 * appended to it. The file is locked while it is read or written, so several processes can share it. The process-wide `instance()` uses the file named by the environment variable
+                 * GT_TUNING_CACHE; if it is not set, the results are only kept for the lifetime of the process.
+                 */
+                class tuning_cache {
+                    struct measurements {
+                        std::vector<double> times = std::vector<double>(candidates().size(),
+                            std::numeric_limits<double>::max());
+                        std::size_t count = 0;
+                    };
+
+                    std::mutex m_mutex;
+                    std::string m_file;
+                    std::map<tuning_key_t, block_sizes> m_results;
+                    std::map<tuning_key_t, measurements> m_measurements;
+
+                    void load() {
+                        locked_file file(m_file, "r", LOCK_SH);
+                        if (!file.get())
+                            return;
+                        unsigned long long spec;
+                        int i_size, j_size, k_size, num_threads, i_block, j_block;
+                        while (std::fscanf(file.get(),
+                                   "%llx %d %d %d %d %d %d",
+                                   &spec,
+                                   &i_size,
+                                   &j_size,
+                                   &k_size,
+                                   &num_threads,
+                                   &i_block,
+                                   &j_block) == 7)
+                            if (i_block > 0 && j_block > 0)
+                                m_results[{spec, i_size, j_size, k_size, num_threads}] = {i_block, j_block};
+                    }
+
+                    void store(tuning_key_t const &key, block_sizes const &sizes) const {
+                        if (m_file.empty())
+                            return;
+                        locked_file file(m_file, "a", LOCK_EX);
+                        if (!file.get()) {
+                            std::fprintf(stderr, "warning: can not write tuning cache file '%s'\n", m_file.c_str());
+                            return;
+                        }
+                        std::fprintf(file.get(),
+                            "%016llx %d %d %d %d %d %d\n",
+                            (unsigned long long)std::get<0>(key),
+                            (int)std::get<1>(key),
+                            (int)std::get<2>(key),
+                            (int)std::get<3>(key),
+                            (int)std::get<4>(key),
+                            (int)sizes.i,
+                            (int)sizes.j);
+                    }
+
+                  public:
+                    explicit tuning_cache(std::string file = {}) : m_file(std::move(file)) {
+                        if (!m_file.empty())
+                            load();
+                    }
+
+                    tuning_cache(tuning_cache const &) = delete;
+                    tuning_cache &operator=(tuning_cache const &) = delete;
+
+                    static tuning_cache &instance() {
+                        const char *file = std::getenv("GT_TUNING_CACHE");
+                        static tuning_cache res(file ? file : "");
+                        return res;
+                    }
+
+                    /**
+                     * @brief Returns the block sizes to be used for the next run and the index of the candidate that
+                     * is measured by this run, or `candidates().size()` if the key is tuned already.
+                     */
+                    std::tuple<block_sizes, std::size_t> get(tuning_key_t const &key) {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        auto found = m_results.find(key);
+                        if (found != m_results.end())
+                            return {found->second, candidates().size()};
+                        auto candidate = m_measurements[key].count % candidates().size();
+                        return {candidates()[candidate], candidate};
+                    }
+
+                    void report(tuning_key_t const &key, std::size_t candidate, double time) {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        if (candidate >= candidates().size() || m_results.count(key))
+                            return;
+                        auto &item = m_measurements[key];
+                        item.times[candidate] = std::min(item.times[candidate], time);
+                        if (++item.count < rounds * candidates().size())
+                            return;
+                        auto best = std::min_element(item.times.begin(), item.times.end()) - item.times.begin();
+                        auto const &res = m_results[key] = candidates()[best];
+                        m_measurements.erase(key);
+                        store(key, res);
+                    }
+                };
+            } // namespace tuning_cache_impl_
+
+            using tuning_cache_impl_::block_sizes;
+            using tuning_cache_impl_::make_tuning_key;
+            using tuning_cache_impl_::tuning_cache;
+            using tuning_cache_impl_::tuning_key_t;
+        } // namespace cpu_kfirst_backend
+    }     // namespace stencil
+} // namespace gridtools
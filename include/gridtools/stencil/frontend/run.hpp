@@ -198,10 +198,15 @@ namespace gridtools {
                 using apply = core::check_valid_apply_overloads<Functor, Interval>;
             };
 
-            template <class Comp, class Backend, class Grid, class... Fields, size_t... Is>
-            auto run_impl(Comp comp, Backend &&be, Grid const &grid, std::index_sequence<Is...>, Fields &&...fields)
-                -> std::void_t<decltype(comp(arg<Is>()...))> {
-                using spec_t = decltype(comp(arg<Is>()...));
+            template <template <class> class Call,
+                class Comp,
+                class Backend,
+                class Grid,
+                class... Fields,
+                size_t... Is,
+                class Spec = decltype(std::declval<Comp>()(arg<Is>()...))>
+            auto run_impl(Comp, Backend &&be, Grid const &grid, std::index_sequence<Is...>, Fields &&...fields) {
+                using spec_t = Spec;
                 static_assert(
                     meta::is_instantiation_of<spec, spec_t>::value, "Invalid stencil composition specification.");
                 static_assert(
@@ -211,7 +216,7 @@ namespace gridtools {
                                   functors_t>::value,
                     "Invalid stencil operator detected.");
 
-                using data_store_map_t = typename hymap::keys<arg<Is>...>::template values<Fields &...>;
+                using data_store_map_t = typename hymap::keys<arg<Is>...>::template values<Fields...>;
 #ifndef NDEBUG
                 using extent_map_t = core::get_extent_map_from_msses<spec_t>;
                 auto check_bounds = [origin = grid.origin(), size = grid.size()](auto arg, auto const &field) {
@@ -230,10 +235,11 @@ namespace gridtools {
                 using loop_t = int[sizeof...(Is)];
                 (void)loop_t{check_bounds(arg<Is>(), fields)...};
 #endif
-                core::call_entry_point_f<spec_t>()(std::forward<Backend>(be), grid, data_store_map_t{fields...});
+                return Call<spec_t>()(
+                    std::forward<Backend>(be), grid, data_store_map_t{std::forward<Fields>(fields)...});
             }
 
-            template <class... Ts>
+            template <template <class> class, class... Ts>
             void run_impl(Ts...) {
                 static_assert(sizeof...(Ts) < 0, "Unexpected first argument of gridtools::stencil::run.");
             }
@@ -242,11 +248,40 @@ namespace gridtools {
             void run(Comp comp, Backend &&be, Grid const &grid, Fields &&...fields) {
                 static_assert(
                     std::conjunction<is_sid<Fields>...>::value, "All computation fields must satisfy SID concept.");
-                run_impl(comp,
+                run_impl<core::call_entry_point_f>(comp,
+                    std::forward<Backend>(be),
+                    grid,
+                    std::index_sequence_for<Fields...>(),
+                    std::forward<Fields>(fields)...);
+            }
+
+            /**
+             *  The result of `make_plan`: a stencil computation that is set up once and can be executed many times.
+             *
+             *  The temporaries and the precomputed pointers and strides of the fields are kept alive between the
+             *  calls of `execute`. The fields that were passed by lvalue reference are referred to, not copied;
+             *  they have to outlive the plan.
+             */
+            template <class Impl>
+            class plan {
+                Impl m_impl;
+
+              public:
+                plan(Impl impl) : m_impl(std::move(impl)) {}
+
+                void execute() { m_impl(); }
+            };
+
+            template <class Comp, class Backend, class Grid, class... Fields>
+            auto make_plan(Comp comp, Backend &&be, Grid const &grid, Fields &&...fields) {
+                static_assert(
+                    std::conjunction<is_sid<Fields>...>::value, "All computation fields must satisfy SID concept.");
+                auto impl = run_impl<core::make_plan_f>(comp,
                     std::forward<Backend>(be),
                     grid,
                     std::index_sequence_for<Fields...>(),
                     std::forward<Fields>(fields)...);
+                return plan<decltype(impl)>(std::move(impl));
             }
 
             template <class F, class Backend, class Grid, class... Fields>
@@ -284,7 +319,9 @@ namespace gridtools {
         using frontend_impl_::execute_parallel;
         using frontend_impl_::get_arg_extent;
         using frontend_impl_::get_arg_intent;
+        using frontend_impl_::make_plan;
         using frontend_impl_::multi_pass;
+        using frontend_impl_::plan;
         using frontend_impl_::run;
         using frontend_impl_::run_single_stage;
     } // namespace stencil
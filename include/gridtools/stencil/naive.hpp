@@ -31,7 +31,7 @@ namespace gridtools {
     namespace stencil {
         struct naive {
             template <class Spec, class Grid, class DataStores>
-            friend void gridtools_backend_entry_point(naive, Spec, Grid const &grid, DataStores external_data_stores) {
+            friend auto gridtools_backend_make_plan(naive, Spec, Grid const &grid, DataStores external_data_stores) {
                 auto alloc = sid::host_device::allocator(&std::make_unique<char[]>);
                 using stages_t = be_api::make_split_view<Spec>;
                 using tmp_plh_map_t = be_api::remove_caches_from_plh_map<typename stages_t::tmp_plh_map_t>;
@@ -58,22 +58,34 @@ namespace gridtools {
                     plh_map_t()));
                 auto origin = sid::get_origin(composite);
                 auto strides = sid::get_strides(composite);
-                for_each<stages_t>([&](auto stage) {
-                    tuple_util::for_each(
-                        [&](auto cell) {
-                            auto ptr = origin();
-                            auto extent = cell.extent();
-                            auto interval = cell.interval();
-                            sid::shift(ptr, sid::get_stride<dim::i>(strides), extent.minus(dim::i()));
-                            sid::shift(ptr, sid::get_stride<dim::j>(strides), extent.minus(dim::j()));
-                            sid::shift(ptr, sid::get_stride<dim::k>(strides), grid.k_start(interval, cell.execution()));
-                            auto i_loop = sid::make_loop<dim::i>(grid.i_size(extent));
-                            auto j_loop = sid::make_loop<dim::j>(grid.j_size(extent));
-                            auto k_loop = sid::make_loop<dim::k>(grid.k_size(interval), cell.k_step());
-                            i_loop(j_loop(k_loop(cell)))(ptr, strides);
-                        },
-                        stage.cells());
-                });
+                return [alloc = std::move(alloc),
+                           data_stores = std::move(data_stores),
+                           origin = std::move(origin),
+                           strides = std::move(strides),
+                           grid] {
+                    for_each<stages_t>([&](auto stage) {
+                        tuple_util::for_each(
+                            [&](auto cell) {
+                                auto ptr = origin();
+                                auto extent = cell.extent();
+                                auto interval = cell.interval();
+                                sid::shift(ptr, sid::get_stride<dim::i>(strides), extent.minus(dim::i()));
+                                sid::shift(ptr, sid::get_stride<dim::j>(strides), extent.minus(dim::j()));
+                                sid::shift(
+                                    ptr, sid::get_stride<dim::k>(strides), grid.k_start(interval, cell.execution()));
+                                auto i_loop = sid::make_loop<dim::i>(grid.i_size(extent));
+                                auto j_loop = sid::make_loop<dim::j>(grid.j_size(extent));
+                                auto k_loop = sid::make_loop<dim::k>(grid.k_size(interval), cell.k_step());
+                                i_loop(j_loop(k_loop(cell)))(ptr, strides);
+                            },
+                            stage.cells());
+                    });
+                };
+            }
+
+            template <class Spec, class Grid, class DataStores>
+            friend void gridtools_backend_entry_point(naive, Spec, Grid const &grid, DataStores external_data_stores) {
+                gridtools_backend_make_plan(naive(), Spec(), grid, std::move(external_data_stores))();
             }
         };
     } // namespace stencil
@@ -0,0 +1,287 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include "../sid/concept.hpp"
+#include "common/intent.hpp"
+#include "frontend/run.hpp"
+
+namespace gridtools {
+    namespace stencil {
+        namespace task_graph_impl_ {
+            template <class Ptr>
+            std::enable_if_t<std::is_pointer_v<Ptr>, void const *> to_identity(Ptr ptr) {
+                return ptr;
+            }
+
+            // fields without a plain pointer (e.g. global parameters) can not be identified; they never create
+            // dependencies
+            template <class Ptr>
+            std::enable_if_t<!std::is_pointer_v<Ptr>, void const *> to_identity(Ptr) {
+                return nullptr;
+            }
+
+            // fields are identified by their origin; two fields that overlap without sharing the origin are not
+            // detected as dependent
+            template <class Field>
+            void const *field_identity(Field const &field) {
+                return to_identity(sid::get_origin(const_cast<Field &>(field))());
+            }
+
+            struct field_access {
+                void const *m_field;
+                bool m_write;
+            };
+
+            template <class Comp, size_t... Is, class... Fields>
+            std::vector<field_access> make_accesses(Comp comp, std::index_sequence<Is...>, Fields const &...fields) {
+                using spec_t = decltype(comp(frontend_impl_::arg<Is>()...));
+                return {{field_identity(fields),
+                    decltype(get_arg_intent(spec_t(), frontend_impl_::arg<Is>()))::value == intent::inout}...};
+            }
+
+            inline int max_threads() {
+#if defined(_OPENMP)
+                return omp_get_max_threads();
+#else
+                return 1;
+#endif
+            }
+
+            inline void set_num_threads(int num_threads) {
+#if defined(_OPENMP)
+                omp_set_num_threads(num_threads);
+#endif
+            }
+
+            /**
+             *  Threads that execute the tasks of a graph together with the calling thread. They are started once and
+             *  wait for the next `run` in between, so their OpenMP thread pools are kept as well.
+             */
+            template <class Task>
+            class runners {
+                std::mutex m_mutex;
+                std::condition_variable m_cv;
+                std::vector<std::thread> m_threads;
+                int m_total_threads;
+                bool m_stop = false;
+                std::size_t m_generation = 0;
+
+                std::vector<Task> const *m_tasks = nullptr;
+                std::deque<std::size_t> m_ready;
+                std::vector<std::size_t> m_pending;
+                std::size_t m_done = 0;
+
+                // executes ready tasks until all tasks of the current run are done
+                void run_tasks(std::unique_lock<std::mutex> &lock) {
+                    while (true) {
+                        m_cv.wait(lock, [&] { return !m_ready.empty() || m_done == m_tasks->size(); });
+                        if (m_ready.empty())
+                            return;
+                        std::size_t id = m_ready.front();
+                        m_ready.pop_front();
+                        auto const &task = (*m_tasks)[id];
+                        lock.unlock();
+                        task.m_execute();
+                        lock.lock();
+                        ++m_done;
+                        for (auto successor : task.m_successors)
+                            if (!--m_pending[successor])
+                                m_ready.push_back(successor);
+                        m_cv.notify_all();
+                    }
+                }
+
+                void worker(int num_threads) {
+                    set_num_threads(num_threads);
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    std::size_t generation = 0;
+                    while (true) {
+                        m_cv.wait(lock, [&] { return m_stop || m_generation != generation; });
+                        if (m_stop)
+                            return;
+                        generation = m_generation;
+                        run_tasks(lock);
+                    }
+                }
+
+              public:
+                runners(int num_runners, int total_threads) : m_total_threads(total_threads) {
+                    for (int i = 1; i < num_runners; ++i)
+                        m_threads.emplace_back(&runners::worker, this, total_threads / num_runners);
+                }
+
+                runners(runners const &) = delete;
+                runners &operator=(runners const &) = delete;
+
+                ~runners() {
+                    {
+                        std::lock_guard<std::mutex> lock(m_mutex);
+                        m_stop = true;
+                    }
+                    m_cv.notify_all();
+                    for (auto &thread : m_threads)
+                        thread.join();
+                }
+
+                int size() const { return m_threads.size() + 1; }
+                int threads() const { return m_total_threads; }
+
+                // executes the tasks in dependency order on all runners, including the calling thread
+                void run(std::vector<Task> const &tasks) {
+                    std::unique_lock<std::mutex> lock(m_mutex);
+                    m_tasks = &tasks;
+                    m_ready.clear();
+                    m_pending.resize(tasks.size());
+                    m_done = 0;
+                    for (std::size_t i = 0; i != tasks.size(); ++i)
+                        if (!(m_pending[i] = tasks[i].m_num_predecessors))
+                            m_ready.push_back(i);
+                    ++m_generation;
+                    m_cv.notify_all();
+                    run_tasks(lock);
+                }
+            };
+
+            /**
+             *  A set of stencil computations that are executed in a dependency driven order.
+             *
+             *  The computations are added in program order. A computation depends on a previously added one if both
+             *  access the same field and at least one of them writes it; the read and write sets are derived from
+             *  `get_arg_intent` of the stencil specification. On `execute`, computations that do not depend on each
+             *  other run concurrently, each with a disjoint subset of the OpenMP threads, so that there is no full
+             *  barrier between independent stencils.
+             *
+             *  Each computation is set up once with `make_plan` when it is added, hence the graph can be executed
+             *  many times. As for plans, fields passed by lvalue reference have to outlive the graph. The runner
+             *  threads are started by the first concurrent `execute` and reused by the following ones.
+             *
+             *  The threads are split among the runners with `omp_set_num_threads`, so only backends that
+             *  parallelize with OpenMP (`cpu_kfirst`, `cpu_ifirst`) stay within the threads of their runner. Other
+             *  backends still run independent computations concurrently, but with their own parallelism. Without
+             *  OpenMP, the computations are executed one after the other.
+             */
+            class task_graph {
+                struct task {
+                    std::function<void()> m_execute;
+                    std::vector<std::size_t> m_successors;
+                    std::size_t m_num_predecessors = 0;
+                    std::size_t m_level = 0;
+                };
+
+                struct field_state {
+                    std::size_t m_last_writer = -1;
+                    std::vector<std::size_t> m_readers;
+                };
+
+                std::vector<task> m_tasks;
+                std::map<void const *, field_state> m_fields;
+                std::unique_ptr<runners<task>> m_runners;
+
+                void add_dependency(std::size_t from, std::size_t to) {
+                    auto &successors = m_tasks[from].m_successors;
+                    if (from == to || std::find(successors.begin(), successors.end(), to) != successors.end())
+                        return;
+                    successors.push_back(to);
+                    ++m_tasks[to].m_num_predecessors;
+                    m_tasks[to].m_level = std::max(m_tasks[to].m_level, m_tasks[from].m_level + 1);
+                }
+
+                void add_task(std::function<void()> execute, std::vector<field_access> const &accesses) {
+                    std::size_t id = m_tasks.size();
+                    m_tasks.push_back({std::move(execute)});
+                    for (auto const &access : accesses) {
+                        if (!access.m_field)
+                            continue;
+                        auto &state = m_fields[access.m_field];
+                        if (state.m_last_writer != std::size_t(-1))
+                            add_dependency(state.m_last_writer, id);
+                        if (access.m_write) {
+                            for (auto reader : state.m_readers)
+                                add_dependency(reader, id);
+                            state.m_readers.clear();
+                            state.m_last_writer = id;
+                        } else {
+                            state.m_readers.push_back(id);
+                        }
+                    }
+                }
+
+                // the maximal number of tasks that can run concurrently, estimated by the widest level of the graph
+                std::size_t width() const {
+                    std::vector<std::size_t> level_sizes;
+                    for (auto const &task : m_tasks) {
+                        if (level_sizes.size() <= task.m_level)
+                            level_sizes.resize(task.m_level + 1);
+                        ++level_sizes[task.m_level];
+                    }
+                    return level_sizes.empty() ? 0 : *std::max_element(level_sizes.begin(), level_sizes.end());
+                }
+
+              public:
+                template <class Comp, class Backend, class Grid, class... Fields>
+                void add(Comp comp, Backend &&be, Grid const &grid, Fields &&...fields) {
+                    auto accesses = make_accesses(comp, std::index_sequence_for<Fields...>(), fields...);
+                    auto plan = make_plan(comp, std::forward<Backend>(be), grid, std::forward<Fields>(fields)...);
+                    add_task([plan = std::make_shared<decltype(plan)>(std::move(plan))] { plan->execute(); }, accesses);
+                }
+
+                std::size_t size() const { return m_tasks.size(); }
+
+                /**
+                 *  @brief The tasks that have to complete before the task `id` (the index in the order of `add`) can
+                 *  start.
+                 */
+                std::vector<std::size_t> predecessors(std::size_t id) const {
+                    std::vector<std::size_t> res;
+                    for (std::size_t i = 0; i != id; ++i) {
+                        auto const &successors = m_tasks[i].m_successors;
+                        if (std::find(successors.begin(), successors.end(), id) != successors.end())
+                            res.push_back(i);
+                    }
+                    return res;
+                }
+
+                void execute() {
+                    int threads = max_threads();
+                    int num_runners = std::max(1, std::min<int>(width(), threads));
+                    if (num_runners == 1) {
+                        for (auto const &task : m_tasks)
+                            task.m_execute();
+                        return;
+                    }
+                    if (!m_runners || m_runners->size() != num_runners || m_runners->threads() != threads)
+                        m_runners = std::make_unique<runners<task>>(num_runners, threads);
+                    set_num_threads(threads / num_runners + threads % num_runners);
+                    m_runners->run(m_tasks);
+                    set_num_threads(threads);
+                }
+            };
+        } // namespace task_graph_impl_
+        using task_graph_impl_::task_graph;
+    } // namespace stencil
+} // namespace gridtools
@@ -11,6 +11,7 @@
 
 #include <tuple>
 #include <type_traits>
+#include <utility>
 
 #include "../common/defs.hpp"
 #include "../common/for_each.hpp"
@@ -47,59 +48,25 @@ namespace gridtools {
                 return obj;
             }
 
-            template <class Layout, class Info>
-            auto restore_indices(Info const &info, Layout, int src) {
-                auto l = info.lengths();
-                auto s = info.strides();
-                array<int, Info::ndims> res;
-                for (size_t i = 0; i < Info::ndims; ++i) {
-                    auto n = Layout::at(i);
-                    if (n == -1)
-                        res[i] = l[i] - 1;
-                    else if (n == 0)
-                        res[i] = src / s[i];
-                    else
-                        res[i] = src % s[Layout::find(n - 1)] / s[i];
-                }
-                return res;
-            }
-
-            template <class Fun, class T, class Layout, class Info, size_t... Is>
-            void initializer_impl(Fun const &fun, T *dst, Layout layout, Info const &info, std::index_sequence<Is...>) {
-                int length = info.length();
-                auto in_range = [&](auto const &indices) {
-                    for (auto ok : {(tuple_util::get<Is>(indices) < tuple_util::get<Is>(info.native_lengths()))...})
-                        if (!ok)
-                            return false;
-                    return true;
-                };
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-                for (int i = 0; i < length; ++i) {
-                    auto indices = restore_indices(info, layout, i);
-                    if (in_range(indices))
-                        dst[i] = fun(tuple_util::get<Is>(indices)...);
-                }
+            template <class Traits, class Fun, class T, class Info, size_t... Is>
+            void initializer_impl(Fun const &fun, T *dst, Info const &info, std::index_sequence<Is...>) {
+                traits::init_loop<Traits>(
+                    info, [&](auto const &indices, int index) { dst[index] = fun(tuple_util::get<Is>(indices)...); });
             }
 
             template <class Fun>
             auto wrap_initializer(Fun fun) {
-                return [fun = std::move(fun)](auto *dst, auto layout, auto const &info) {
-                    initializer_impl(
-                        fun, dst, layout, info, std::make_index_sequence<std::decay_t<decltype(info)>::ndims>());
+                return [fun = std::move(fun)](auto storage_traits, auto *dst, auto const &info) {
+                    initializer_impl<decltype(storage_traits)>(
+                        fun, dst, info, std::make_index_sequence<std::decay_t<decltype(info)>::ndims>());
                 };
             }
 
             template <class T>
             auto wrap_value(T const &value) {
-                return [value = std::move(value)](auto *dst, auto, auto const &info) {
-                    int length = info.length();
-#ifdef _OPENMP
-#pragma omp parallel for
-#endif
-                    for (int i = 0; i < length; ++i)
-                        dst[i] = value;
+                return [value = std::move(value)](auto storage_traits, auto *dst, auto const &info) {
+                    traits::init_loop<decltype(storage_traits)>(
+                        info, [&](auto const &, int index) { dst[index] = value; });
                 };
             }
 
@@ -300,7 +267,14 @@ namespace gridtools {
                     return add_value<param::initializer>(wrap_value(std::move(value)));
                 }
 
-                auto build() const {
+                /**
+                 *  Calls `make(traits, type, id, name, lengths, halos, initializer)` with the parameters of the
+                 *  builder, where `traits` is the storage traits with the layout of the builder applied, and `type`
+                 *  and `id` are `meta::lazy::id` of the element type and of the id (`void` if not set). This allows
+                 *  factories other than `build` to be defined outside of the builder.
+                 */
+                template <class Make>
+                auto build_with(Make &&make) const {
                     static_assert(has<param::type>::value, "storage type is not set");
                     static_assert(has<param::lengths>::value, "storage lengths are not set");
                     using traits_t =
@@ -310,8 +284,21 @@ namespace gridtools {
                     constexpr auto n = tuple_util::size<decltype(lengths)>::value;
                     auto &&halos = value<param::halos, array<int, n>>();
                     auto initializer = value<param::initializer, uninitialized>();
-                    return make_data_store<traits_t, typename value_type<param::type>::type, value_type<param::id>>(
-                        name, lengths, halos, initializer);
+                    return std::forward<Make>(make)(traits_t(),
+                        value_type<param::type>(),
+                        meta::lazy::id<value_type<param::id>>(),
+                        name,
+                        lengths,
+                        halos,
+                        initializer);
+                }
+
+                auto build() const {
+                    return build_with([](auto traits, auto type, auto id, auto const &...args) {
+                        using data_t = typename decltype(type)::type;
+                        using id_t = typename decltype(id)::type;
+                        return make_data_store<decltype(traits), data_t, id_t>(args...);
+                    });
                 }
 
                 auto operator()() const { return build(); }
@@ -0,0 +1,242 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * Allocation of bundles of same-shaped data stores from a single arena.
+ *
+ * `build_bundle<N>(builder)` builds `N` data stores with the parameters of the builder, where each data store is
+ * a normal data store (and SID) with `bundled<Traits>` traits. The memory of all fields comes from one
+ * `hugepage_alloc` allocation instead of one per field, which saves the rounding of every field to a huge page and
+ * the TLB entries for them. The arena is freed when the last field of the bundle is destroyed.
+ *
+ * Two placements are available:
+ *  - `separate_fields` (default): the fields follow each other in the arena, field `i + 1` starts `field_offset`
+ *    bytes (default: `cache_line_size`) after the end of field `i`. The offsets shift consecutive fields to different
+ *    cache sets, like `hugepage_alloc` does for separate allocations;
+ *  - `interleaved_fields`: the fields are interleaved along their outermost dimension (j-planes for `cpu_ifirst`,
+ *    i-planes for `cpu_kfirst`), so that the planes with the same outermost index of all fields are contiguous in
+ *    memory. The strides of such fields differ from the ones of separately allocated fields, so they get their own
+ *    strides kind.
+ *
+ * If a name is given to the builder, the fields are named `<name>_<index>`.
+ */
+
+#pragma once
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "../common/array.hpp"
+#include "../common/hugepage_alloc.hpp"
+#include "../common/integral_constant.hpp"
+#include "../common/tuple.hpp"
+#include "../common/tuple_util.hpp"
+#include "../meta.hpp"
+#include "../sid/unknown_kind.hpp"
+#include "data_store.hpp"
+#include "info.hpp"
+#include "traits.hpp"
+
+namespace gridtools {
+    namespace storage {
+        struct separate_fields {};
+        struct interleaved_fields {};
+
+        // the default distance of separate fields in a bundle
+        inline constexpr std::size_t cache_line_size = 64;
+
+        namespace bundle_impl_ {
+            struct arena_deleter {
+                void operator()(char *p) const { hugepage_free(p); }
+            };
+
+            // keeps the arena alive as long as any of its fields
+            struct field_deleter {
+                std::shared_ptr<char> m_arena;
+
+                template <class T>
+                void operator()(T *) const {}
+            };
+
+            // the arena the fields of the bundle that is being built are taken from
+            struct arena_state {
+                std::shared_ptr<char> m_arena;
+                std::size_t m_size;
+                std::size_t m_step;
+                std::size_t m_next = 0;
+            };
+
+            inline arena_state *&current_arena() {
+                thread_local arena_state *res = nullptr;
+                return res;
+            }
+
+            class arena_scope {
+                arena_state *m_prev;
+
+              public:
+                arena_scope(arena_state &state) : m_prev(current_arena()) { current_arena() = &state; }
+                arena_scope(arena_scope const &) = delete;
+                arena_scope &operator=(arena_scope const &) = delete;
+                ~arena_scope() { current_arena() = m_prev; }
+            };
+
+            inline std::shared_ptr<char> make_arena(std::size_t size) {
+                return {static_cast<char *>(hugepage_alloc(size)), arena_deleter()};
+            }
+
+            // takes the next field from the current arena, a data store that is built outside of a bundle gets its
+            // own arena
+            template <class T>
+            std::unique_ptr<T[], field_deleter> allocate(std::size_t size) {
+                std::size_t bytes = size * sizeof(T);
+                arena_state *state = current_arena();
+                if (!state) {
+                    auto arena = make_arena(bytes);
+                    return {reinterpret_cast<T *>(arena.get()), {std::move(arena)}};
+                }
+                assert(state->m_next + bytes <= state->m_size);
+                auto res = reinterpret_cast<T *>(state->m_arena.get() + state->m_next);
+                state->m_next += state->m_step;
+                return {res, {state->m_arena}};
+            }
+
+            template <size_t I, size_t Outer, size_t N, class Stride>
+            auto interleave_stride(Stride const &stride) {
+                if constexpr (I == Outer)
+                    return stride * integral_constant<int, N>();
+                else
+                    return stride;
+            }
+
+            template <size_t Outer, size_t N, class Strides, size_t... Is>
+            auto interleave_strides(Strides const &strides, std::index_sequence<Is...>) {
+                return tuple(interleave_stride<Is, Outer, N>(tuple_util::get<Is>(strides))...);
+            }
+        } // namespace bundle_impl_
+
+        /**
+         *  Storage traits for the fields of a bundle. Layout, alignment and initialization blocks are the ones of
+         *  `Traits`, which must be host referenceable.
+         */
+        template <class Traits>
+        struct bundled {
+            static_assert(traits::is_host_referenceable<Traits>, "bundles are allocated in host memory");
+
+            friend std::true_type storage_is_host_referenceable(bundled) { return {}; }
+
+            template <size_t Dims>
+            friend auto storage_layout(bundled, std::integral_constant<size_t, Dims> dims) {
+                return storage_layout(Traits(), dims);
+            }
+
+            friend auto storage_alignment(bundled) { return storage_alignment(Traits()); }
+
+            template <size_t Dims>
+            friend auto storage_init_block_sizes(bundled, std::integral_constant<size_t, Dims> dims) {
+                using traits::storage_init_block_sizes;
+                return storage_init_block_sizes(Traits(), dims);
+            }
+
+            template <class LazyType, class T = typename LazyType::type>
+            friend auto storage_allocate(bundled, LazyType, size_t size) {
+                return bundle_impl_::allocate<T>(size);
+            }
+        };
+
+        namespace bundle_impl_ {
+            template <class Traits, class T, size_t N, class Lengths>
+            auto make_bundle_info(separate_fields, Lengths const &lengths) {
+                return traits::make_info<Traits, T>(lengths);
+            }
+
+            template <class Traits, class T, size_t N, class Lengths>
+            auto make_bundle_info(interleaved_fields, Lengths const &lengths) {
+                constexpr size_t ndims = tuple_util::size<Lengths>::value;
+                using layout_t = traits::layout_type<Traits, ndims>;
+                static_assert(
+                    layout_t::unmasked_length > 1, "only fields with more than one dimension can be interleaved");
+                auto info = traits::make_info<Traits, T>(lengths);
+                return info_impl_::make_info_helper(info.native_lengths(),
+                    interleave_strides<layout_t::find(0), N>(info.native_strides(), std::make_index_sequence<ndims>()));
+            }
+
+            template <class Traits, class T, size_t N, class Lengths, class Id, class Mode>
+            using bundle_kind = meta::if_<std::is_same<Mode, interleaved_fields>,
+                meta::if_<std::is_same<Id, sid::unknown_kind>,
+                    Id,
+                    meta::list<traits::strides_kind<Traits, T, Lengths, Id>, Mode, integral_constant<size_t, N>>>,
+                traits::strides_kind<Traits, T, Lengths, Id>>;
+
+            template <class Traits,
+                class T,
+                class Id,
+                size_t N,
+                class Mode,
+                class Lengths,
+                class Halos,
+                class Initializer>
+            auto make_bundle(std::string const &name,
+                Lengths const &lengths,
+                Halos const &halos,
+                Initializer const &initializer,
+                std::size_t field_offset) {
+                static_assert(N > 0, "empty bundle");
+                using traits_t = bundled<Traits>;
+                auto info = make_bundle_info<traits_t, T, N>(Mode(), lengths);
+                using kind_t = bundle_kind<traits_t, T, N, Lengths, Id, Mode>;
+                // the size that is allocated by each data store
+                std::size_t field_bytes = (info.length() + traits::elem_alignment<traits_t, T>) * sizeof(T);
+                // the distance of the fields in the arena
+                std::size_t step;
+                if constexpr (std::is_same_v<Mode, interleaved_fields>) {
+                    constexpr size_t outer = traits::layout_type<traits_t, tuple_util::size<Lengths>::value>::find(0);
+                    step = info.strides()[outer] / N * sizeof(T);
+                } else {
+                    constexpr std::size_t alignment = traits::byte_alignment<traits_t>;
+                    step = (field_bytes + field_offset + alignment - 1) / alignment * alignment;
+                }
+                std::size_t size = (N - 1) * step + field_bytes;
+                arena_state state{make_arena(size), size, step};
+                arena_scope scope(state);
+                using data_store_ptr_t = decltype(data_store_impl_::make_data_store_helper<traits_t, T, kind_t>(
+                    name, info, halos, initializer));
+                std::array<data_store_ptr_t, N> res;
+                for (size_t i = 0; i != N; ++i)
+                    res[i] = data_store_impl_::make_data_store_helper<traits_t, T, kind_t>(
+                        name.empty() ? name : name + "_" + std::to_string(i), info, halos, initializer);
+                return res;
+            }
+
+            /**
+             *  Builds `N` data stores with the parameters of `builder` from a single allocation. `Mode` is
+             *  `separate_fields` or `interleaved_fields`, `field_offset` is the additional distance of separate fields
+             *  in bytes.
+             */
+            template <size_t N, class Mode = separate_fields, class Builder>
+            auto build_bundle(Builder const &builder, size_t field_offset = cache_line_size) {
+                return builder.build_with([&](auto traits, auto type, auto id, auto const &...args) {
+                    using data_t = typename decltype(type)::type;
+                    using id_t = typename decltype(id)::type;
+                    return make_bundle<decltype(traits), data_t, id_t, N, Mode>(args..., field_offset);
+                });
+            }
+        } // namespace bundle_impl_
+
+        using bundle_impl_::build_bundle;
+    } // namespace storage
+} // namespace gridtools
@@ -0,0 +1,262 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+/**
+ * @file
+ *
+ * Binary checkpoints of data stores.
+ *
+ * A checkpoint file is a sequence of records, one per data store, written by `checkpoint_writer::write` and read back
+ * in the same order by `checkpoint_reader::read`. A record consists of a header block with the element type, the
+ * lengths, strides, layout and halos of the data store, followed by the raw memory of the data store including the
+ * padding. Both are aligned to `checkpoint_block_size` in the file and the data is transferred in chunks of
+ * `checkpoint_chunk_size` bytes by all OpenMP threads.
+ *
+ * On reading, the element type, the lengths and the name must match. If the layout and the strides match as well, the
+ * data is read directly into the memory of the data store, otherwise it is read into a buffer and copied with
+ * `transform_layout`.
+ *
+ * Data is stored in the native byte order.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <typeinfo>
+
+#include <fcntl.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#include "../common/array.hpp"
+#include "../common/defs.hpp"
+#include "../layout_transformation.hpp"
+
+namespace gridtools {
+    namespace storage {
+        namespace checkpoint_impl_ {
+            constexpr std::size_t checkpoint_block_size = 4096;
+            constexpr std::size_t checkpoint_chunk_size = 1 << 22;
+            constexpr std::size_t max_dims = 16;
+            constexpr char magic[8] = {'G', 'T', 'C', 'K', 'P', 'T', 0, 1};
+
+            struct record_header {
+                char m_magic[8];
+                std::uint32_t m_elem_size;
+                std::uint32_t m_ndims;
+                char m_elem_type[128];
+                char m_name[128];
+                std::int64_t m_length;
+                std::int64_t m_lengths[max_dims];
+                std::int64_t m_strides[max_dims];
+                std::int64_t m_layout[max_dims];
+                std::int64_t m_halos[max_dims];
+            };
+            static_assert(sizeof(record_header) <= checkpoint_block_size);
+
+            inline std::uint64_t round_up(std::uint64_t size) {
+                return (size + checkpoint_block_size - 1) / checkpoint_block_size * checkpoint_block_size;
+            }
+
+            [[noreturn]] inline void fail(std::string const &what, std::string const &path, std::string const &reason) {
+                throw std::runtime_error("gridtools::storage::checkpoint: " + what + " " + path + ": " + reason);
+            }
+
+            [[noreturn]] inline void fail(std::string const &what, std::string const &path, int error = errno) {
+                fail(what, path, std::strerror(error));
+            }
+
+            // `errno` of a failed transfer, or `unexpected_eof` if a transfer stopped early
+            constexpr int unexpected_eof = -1;
+
+            [[noreturn]] inline void fail_transfer(std::string const &what, std::string const &path, int error) {
+                if (error == unexpected_eof)
+                    fail(what, path, "unexpected end of file");
+                fail(what, path, error);
+            }
+
+            inline void copy_string(char *dst, std::size_t size, std::string const &src) {
+                std::memset(dst, 0, size);
+                std::memcpy(dst, src.data(), std::min(size - 1, src.size()));
+            }
+
+            // transfers `size` bytes at file offset `offset` in chunks, in parallel; returns 0 on success, otherwise
+            // the `errno` of a failed transfer or `unexpected_eof` (errno is thread local, so it is passed on here)
+            template <class Transfer>
+            int transfer_chunks(std::uint64_t offset, std::uint64_t size, Transfer const &transfer) {
+                std::int64_t num_chunks = (size + checkpoint_chunk_size - 1) / checkpoint_chunk_size;
+                int error = 0;
+                bool eof = false;
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) reduction(max : error) reduction(|| : eof)
+#endif
+                for (std::int64_t chunk = 0; chunk < num_chunks; ++chunk) {
+                    std::uint64_t begin = chunk * checkpoint_chunk_size;
+                    std::uint64_t end = std::min<std::uint64_t>(begin + checkpoint_chunk_size, size);
+                    while (!error && !eof && begin != end) {
+                        auto done = transfer(offset + begin, begin, end - begin);
+                        if (done < 0)
+                            error = errno;
+                        else if (done == 0)
+                            eof = true;
+                        else
+                            begin += done;
+                    }
+                }
+                return error ? error : eof ? unexpected_eof : 0;
+            }
+
+            class checkpoint_writer {
+                std::string m_path;
+                int m_fd;
+                std::uint64_t m_offset = 0;
+
+              public:
+                explicit checkpoint_writer(std::string path)
+                    : m_path(std::move(path)), m_fd(open(m_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)) {
+                    if (m_fd == -1)
+                        fail("can not create", m_path);
+                }
+                checkpoint_writer(checkpoint_writer const &) = delete;
+                checkpoint_writer &operator=(checkpoint_writer const &) = delete;
+                ~checkpoint_writer() { close(m_fd); }
+
+                // appends a record with the contents of the data store
+                template <class DataStorePtr>
+                void write(DataStorePtr const &ds) {
+                    using data_store_t = typename DataStorePtr::element_type;
+                    using data_t = typename data_store_t::data_t;
+                    using layout_t = typename data_store_t::layout_t;
+                    static_assert(data_store_t::ndims <= max_dims, "too many dimensions");
+
+                    record_header header = {};
+                    std::memcpy(header.m_magic, magic, sizeof(magic));
+                    header.m_elem_size = sizeof(data_t);
+                    header.m_ndims = data_store_t::ndims;
+                    copy_string(header.m_elem_type, sizeof(header.m_elem_type), typeid(data_t).name());
+                    copy_string(header.m_name, sizeof(header.m_name), ds->name());
+                    header.m_length = ds->length();
+                    for (std::size_t d = 0; d != data_store_t::ndims; ++d) {
+                        header.m_lengths[d] = ds->lengths()[d];
+                        header.m_strides[d] = ds->strides()[d];
+                        header.m_layout[d] = layout_t::at(d);
+                        header.m_halos[d] = ds->halos()[d];
+                    }
+                    auto block = std::make_unique<char[]>(checkpoint_block_size);
+                    std::memcpy(block.get(), &header, sizeof(header));
+                    if (pwrite(m_fd, block.get(), checkpoint_block_size, m_offset) != (ssize_t)checkpoint_block_size)
+                        fail("can not write", m_path);
+                    m_offset += checkpoint_block_size;
+
+                    std::uint64_t size = header.m_length * sizeof(data_t);
+                    auto src = reinterpret_cast<char const *>(ds->get_const_host_ptr());
+                    if (int error = transfer_chunks(
+                            m_offset, size, [&](std::uint64_t offset, std::uint64_t pos, std::size_t n) {
+                                return pwrite(m_fd, src + pos, n, offset);
+                            }))
+                        fail_transfer("can not write", m_path, error);
+                    m_offset += round_up(size);
+                }
+            };
+
+            class checkpoint_reader {
+                std::string m_path;
+                int m_fd;
+                std::uint64_t m_offset = 0;
+
+              public:
+                explicit checkpoint_reader(std::string path)
+                    : m_path(std::move(path)), m_fd(open(m_path.c_str(), O_RDONLY)) {
+                    if (m_fd == -1)
+                        fail("can not open", m_path);
+                }
+                checkpoint_reader(checkpoint_reader const &) = delete;
+                checkpoint_reader &operator=(checkpoint_reader const &) = delete;
+                ~checkpoint_reader() { close(m_fd); }
+
+                // reads the next record into the data store
+                template <class DataStorePtr>
+                void read(DataStorePtr const &ds) {
+                    using data_store_t = typename DataStorePtr::element_type;
+                    using data_t = typename data_store_t::data_t;
+                    constexpr std::size_t ndims = data_store_t::ndims;
+
+                    using layout_t = typename data_store_t::layout_t;
+
+                    record_header header;
+                    auto header_bytes = pread(m_fd, &header, sizeof(header), m_offset);
+                    if (header_bytes == -1)
+                        fail("can not read", m_path);
+                    if (header_bytes != (ssize_t)sizeof(header))
+                        fail_transfer("can not read", m_path, unexpected_eof);
+                    if (std::memcmp(header.m_magic, magic, sizeof(magic)) != 0)
+                        fail("can not read", m_path, "no checkpoint record");
+                    m_offset += checkpoint_block_size;
+
+                    bool same_type =
+                        header.m_elem_size == sizeof(data_t) && header.m_ndims == ndims &&
+                        std::strncmp(header.m_elem_type, typeid(data_t).name(), sizeof(header.m_elem_type) - 1) == 0;
+                    if (!same_type)
+                        fail("element type does not match for " + ds->name() + " in", m_path, EINVAL);
+                    std::string name(header.m_name, strnlen(header.m_name, sizeof(header.m_name)));
+                    if (name != ds->name().substr(0, sizeof(header.m_name) - 1))
+                        fail("name " + name + " does not match for " + ds->name() + " in", m_path, EINVAL);
+                    bool same_strides = header.m_length == ds->length();
+                    // the largest offset of an element, to check that the stored strides are within the data
+                    std::int64_t last = 0;
+                    for (std::size_t d = 0; d != ndims; ++d) {
+                        if (header.m_lengths[d] != ds->lengths()[d])
+                            fail("lengths do not match for " + ds->name() + " in", m_path, EINVAL);
+                        same_strides = same_strides && header.m_layout[d] == layout_t::at(d) &&
+                                       header.m_strides[d] == ds->strides()[d];
+                        if (header.m_strides[d] < 0)
+                            fail("invalid strides for " + ds->name() + " in", m_path, EINVAL);
+                        if (header.m_lengths[d] > 0)
+                            last += (header.m_lengths[d] - 1) * header.m_strides[d];
+                    }
+                    if (header.m_length < 0 || (ds->length() > 0 && last >= header.m_length))
+                        fail("invalid strides for " + ds->name() + " in", m_path, EINVAL);
+
+                    std::uint64_t size = header.m_length * sizeof(data_t);
+                    data_t *dst = ds->get_host_ptr();
+                    std::unique_ptr<data_t[]> buffer;
+                    if (!same_strides) {
+                        buffer = std::make_unique<data_t[]>(header.m_length);
+                        dst = buffer.get();
+                    }
+                    auto bytes = reinterpret_cast<char *>(dst);
+                    if (int error = transfer_chunks(
+                            m_offset, size, [&](std::uint64_t offset, std::uint64_t pos, std::size_t n) {
+                                return pread(m_fd, bytes + pos, n, offset);
+                            }))
+                        fail_transfer("can not read", m_path, error);
+                    m_offset += round_up(size);
+
+                    if (!same_strides) {
+                        array<uint_t, ndims> src_strides;
+                        for (std::size_t d = 0; d != ndims; ++d)
+                            src_strides[d] = header.m_strides[d];
+                        transform_layout(ds->get_host_ptr(), dst, ds->lengths(), ds->strides(), src_strides);
+                    }
+                }
+            };
+        } // namespace checkpoint_impl_
+
+        using checkpoint_impl_::checkpoint_reader;
+        using checkpoint_impl_::checkpoint_writer;
+    } // namespace storage
+} // namespace gridtools
@@ -12,6 +12,7 @@
 #include <memory>
 #include <type_traits>
 
+#include "../common/array.hpp"
 #include "../common/hugepage_alloc.hpp"
 #include "../common/integral_constant.hpp"
 #include "../common/layout_map.hpp"
@@ -51,6 +52,14 @@ namespace gridtools {
 
             friend integral_constant<size_t, 64> storage_alignment(cpu_ifirst) { return {}; }
 
+            // the backend assigns contiguous ranges of j to the threads
+            template <size_t Dims>
+            friend array<int, Dims> storage_init_block_sizes(cpu_ifirst, std::integral_constant<size_t, Dims>) {
+                array<int, Dims> res = {};
+                res[Dims > 1 ? 1 : 0] = 1;
+                return res;
+            }
+
             template <class LazyType, class T = typename LazyType::type>
             friend auto storage_allocate(cpu_ifirst, LazyType, size_t size) {
                 return std::unique_ptr<T[], cpu_ifirst_impl_::deleter>(
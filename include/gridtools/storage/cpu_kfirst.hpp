@@ -9,9 +9,11 @@
  */
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <type_traits>
 
+#include "../common/array.hpp"
 #include "../common/integral_constant.hpp"
 #include "../common/layout_map.hpp"
 
@@ -51,10 +53,25 @@ namespace gridtools {
 
             friend integral_constant<size_t, 1> storage_alignment(cpu_kfirst) { return {}; }
 
+            // the backend distributes 8x8 blocks in the i-j-plane over the threads, each with the full k range
+            template <size_t Dims>
+            friend array<int, Dims> storage_init_block_sizes(cpu_kfirst, std::integral_constant<size_t, Dims>) {
+                array<int, Dims> res = {};
+                for (size_t d = 0; d != std::min<size_t>(Dims, 2); ++d)
+                    res[d] = 8;
+                return res;
+            }
+
             template <class LazyType, class T = typename LazyType::type>
             friend auto storage_allocate(cpu_kfirst, LazyType, size_t size) {
                 return std::make_unique<T[]>(size);
             }
+
+            // default initialized to leave the first touch to the initializer
+            template <class LazyType, class T = typename LazyType::type>
+            friend auto storage_allocate_for_overwrite(cpu_kfirst, LazyType, size_t size) {
+                return std::unique_ptr<T[]>(new T[size]);
+            }
         };
     } // namespace storage
 } // namespace gridtools
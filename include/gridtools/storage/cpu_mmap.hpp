@@ -0,0 +1,155 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../common/integral_constant.hpp"
+#include "cpu_ifirst.hpp"
+#include "data_store.hpp"
+
+namespace gridtools {
+    namespace storage {
+        namespace cpu_mmap_impl_ {
+            struct unmap {
+                std::size_t m_size;
+
+                template <class T>
+                void operator()(T *p) const {
+                    munmap(const_cast<std::remove_cv_t<T> *>(p), m_size);
+                }
+            };
+
+            [[noreturn]] inline void fail(std::string const &what, std::string const &path) {
+                throw std::runtime_error(
+                    "gridtools::storage::cpu_mmap: " + what + " " + path + ": " + std::strerror(errno));
+            }
+
+            inline void *map_anonymous(std::size_t size) {
+                void *res = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                if (res == MAP_FAILED)
+                    fail("can not allocate", std::to_string(size) + " bytes");
+                return res;
+            }
+
+            /*
+             * Maps the file at `path`, which must either have the given size or (for shared mappings) be empty or
+             * missing, in which case it is created and extended to the size. A missing file with a private mapping
+             * gives zero initialized memory.
+             */
+            inline void *map_file(std::string const &path, std::size_t size, bool shared) {
+                int fd = open(path.c_str(), shared ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+                if (fd == -1) {
+                    if (!shared && errno == ENOENT)
+                        return map_anonymous(size);
+                    fail("can not open", path);
+                }
+                struct stat st;
+                if (fstat(fd, &st) == -1) {
+                    close(fd);
+                    fail("can not stat", path);
+                }
+                if (shared && st.st_size == 0) {
+                    if (ftruncate(fd, size) == -1) {
+                        close(fd);
+                        fail("can not resize", path);
+                    }
+                } else if (std::size_t(st.st_size) != size) {
+                    close(fd);
+                    errno = EINVAL;
+                    fail("size mismatch of " + std::to_string(st.st_size) + " bytes instead of " +
+                             std::to_string(size) + " in",
+                        path);
+                }
+                void *res = mmap(nullptr, size, PROT_READ | PROT_WRITE, shared ? MAP_SHARED : MAP_PRIVATE, fd, 0);
+                close(fd);
+                if (res == MAP_FAILED)
+                    fail("can not map", path);
+                return res;
+            }
+
+            template <class T>
+            std::unique_ptr<T[], unmap> map(std::size_t size, std::string const &path, bool shared) {
+                static_assert(std::is_trivially_copyable_v<T>, "only trivially copyable types can be mapped");
+                std::size_t bytes = size * sizeof(T);
+                // mmap fails for zero lengths, there is nothing to map or to write back anyway
+                if (bytes == 0)
+                    return {nullptr, unmap{0}};
+                void *res = path.empty() ? map_anonymous(bytes) : map_file(path, bytes, shared);
+                return {static_cast<T *>(res), unmap{bytes}};
+            }
+        } // namespace cpu_mmap_impl_
+
+        /**
+         *  Storage traits that map the memory of a data store from the file given by the name of the data store.
+         *  Layout, alignment and initialization blocks are the ones of `Traits`, so the data is placed at the same
+         *  offsets in the file as in the memory of a `Traits` data store.
+         *
+         *  With `Shared`, the file is created if it does not exist and modifications are written back to it (see
+         *  `flush`); otherwise the mapping is private and the file is only read. Either way, pages are read lazily on
+         *  first access. A data store that is built without initializer attaches to the contents of the file, which
+         *  must have been written by a data store of the same type, lengths and halos. Data stores without name get
+         *  anonymous memory. Empty allocations map nothing, not even the file.
+         */
+        template <class Traits = cpu_ifirst, bool Shared = true>
+        struct cpu_mmap {
+            friend std::true_type storage_is_host_referenceable(cpu_mmap) { return {}; }
+
+            template <size_t Dims>
+            friend auto storage_layout(cpu_mmap, std::integral_constant<size_t, Dims> dims) {
+                return storage_layout(Traits(), dims);
+            }
+
+            friend auto storage_alignment(cpu_mmap) { return storage_alignment(Traits()); }
+
+            template <size_t Dims>
+            friend auto storage_init_block_sizes(cpu_mmap, std::integral_constant<size_t, Dims> dims) {
+                using traits::storage_init_block_sizes;
+                return storage_init_block_sizes(Traits(), dims);
+            }
+
+            template <class LazyType, class T = typename LazyType::type>
+            friend auto storage_allocate(cpu_mmap, LazyType, size_t size) {
+                return cpu_mmap_impl_::map<T>(size, {}, Shared);
+            }
+
+            template <class LazyType, class T = typename LazyType::type>
+            friend auto storage_allocate(cpu_mmap, LazyType, size_t size, std::string const &name) {
+                return cpu_mmap_impl_::map<T>(size, name, Shared);
+            }
+        };
+
+        /**
+         *  Synchronously writes the data of a data store with shared `cpu_mmap` traits back to its file, for example
+         *  for checkpointing.
+         */
+        template <class Traits, class T, class Info, class Kind, bool IsConst>
+        void flush(data_store_impl_::data_store<cpu_mmap<Traits, true>, T, Info, Kind, IsConst, true> const &ds) {
+            static const std::uintptr_t page_size = sysconf(_SC_PAGESIZE);
+            auto begin = reinterpret_cast<std::uintptr_t>(ds.get_const_target_ptr());
+            auto end = begin + ds.length() * sizeof(T);
+            begin = begin / page_size * page_size;
+            if (end > begin && msync(reinterpret_cast<void *>(begin), end - begin, MS_SYNC) == -1)
+                cpu_mmap_impl_::fail("can not flush", ds.name());
+        }
+    } // namespace storage
+} // namespace gridtools
@@ -20,6 +20,7 @@
 #include "../common/defs.hpp"
 #include "../common/integral_constant.hpp"
 #include "../common/layout_map.hpp"
+#include "../common/tuple_util.hpp"
 #include "data_view.hpp"
 #include "info.hpp"
 #include "traits.hpp"
@@ -42,6 +43,7 @@ namespace gridtools {
 
                 std::string m_name;
                 Info m_info;
+                array<int, Info::ndims> m_halos;
                 traits::target_ptr_type<Traits, mutable_data_t> m_target_ptr_holder;
                 mutable_data_t *m_target_ptr;
 
@@ -58,12 +60,17 @@ namespace gridtools {
                 decltype(auto) lengths() const { return m_info.lengths(); }
                 decltype(auto) strides() const { return m_info.strides(); }
                 decltype(auto) length() const { return m_info.length(); }
+                auto const &halos() const { return m_halos; }
 
               protected:
                 template <class Halos>
-                base(std::string name, Info info, Halos const &halos)
+                base(std::string name, Info info, Halos const &halos, bool for_overwrite)
                     : m_name(std::move(name)), m_info(std::move(info)),
-                      m_target_ptr_holder(traits::allocate<Traits, mutable_data_t>(m_info.length() + alignment_t())) {
+                      m_halos(tuple_util::convert_to<array, int>(halos)),
+                      m_target_ptr_holder(for_overwrite ? traits::allocate_for_overwrite<Traits, mutable_data_t>(
+                                                              m_info.length() + alignment_t(), m_name)
+                                                        : traits::allocate<Traits, mutable_data_t>(
+                                                              m_info.length() + alignment_t(), m_name)) {
                     auto offset_to_align = m_info.index_from_tuple(halos);
                     auto byte_offset = offset_to_align * sizeof(T);
                     auto address_to_align = reinterpret_cast<std::uintptr_t>(m_target_ptr_holder.get()) + byte_offset;
@@ -105,14 +112,14 @@ namespace gridtools {
               public:
                 template <class Halos>
                 data_store(std::string name, Info info, Halos const &halos, uninitialized const &)
-                    : data_store::base(std::move(name), std::move(info), halos), m_state(synced),
+                    : data_store::base(std::move(name), std::move(info), halos, false), m_state(synced),
                       m_host_ptr(std::make_unique<T[]>(this->info().length())) {}
 
                 template <class Initializer, class Halos>
                 data_store(std::string name, Info info, Halos const &halos, Initializer const &initializer)
-                    : data_store::base(std::move(name), std::move(info), halos), m_state(invalid_target),
+                    : data_store::base(std::move(name), std::move(info), halos, true), m_state(invalid_target),
                       m_host_ptr(std::make_unique<T[]>(this->info().length())) {
-                    initializer(m_host_ptr.get(), typename data_store::layout_t(), this->info());
+                    initializer(Traits(), m_host_ptr.get(), this->info());
                 }
 
                 T *get_target_ptr() {
@@ -151,12 +158,12 @@ namespace gridtools {
               public:
                 template <class Halos>
                 data_store(std::string name, Info info, Halos const &halos, uninitialized const &)
-                    : data_store::base(std::move(name), std::move(info), halos) {}
+                    : data_store::base(std::move(name), std::move(info), halos, false) {}
 
                 template <class Initializer, class Halos>
                 data_store(std::string name, Info info, Halos const &halos, Initializer const &initializer)
-                    : data_store::base(std::move(name), std::move(info), halos) {
-                    initializer(this->raw_target_ptr(), typename data_store::layout_t(), this->info());
+                    : data_store::base(std::move(name), std::move(info), halos, true) {
+                    initializer(Traits(), this->raw_target_ptr(), this->info());
                 }
 
                 T *get_target_ptr() const { return this->raw_target_ptr(); }
@@ -183,13 +190,13 @@ namespace gridtools {
                 template <class Initializer, std::enable_if_t<!is_host_refrenceable<Initializer>::value, int> = 0>
                 void init(Initializer const &initializer) {
                     auto host_ptr = std::make_unique<T[]>(this->info().length());
-                    initializer(host_ptr.get(), typename data_store::layout_t(), this->info());
+                    initializer(Traits(), host_ptr.get(), this->info());
                     traits::update_target<Traits>(this->raw_target_ptr(), host_ptr.get(), this->info().length());
                 }
 
                 template <class Initializer, std::enable_if_t<is_host_refrenceable<Initializer>::value, int> = 0>
                 void init(Initializer const &initializer) {
-                    initializer(this->raw_target_ptr(), typename data_store::layout_t(), this->info());
+                    initializer(Traits(), this->raw_target_ptr(), this->info());
                 }
 
               public:
@@ -198,7 +205,7 @@ namespace gridtools {
 
                 template <class Initializer, class Halos>
                 data_store(std::string name, Info info, Halos const &halos, Initializer const &initializer)
-                    : base<Traits, T const, Info, Kind>(std::move(name), std::move(info), halos) {
+                    : base<Traits, T const, Info, Kind>(std::move(name), std::move(info), halos, true) {
                     init(initializer);
                 }
                 T const *get_target_ptr() const { return this->raw_target_ptr(); }
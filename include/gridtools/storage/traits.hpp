@@ -9,9 +9,13 @@
  */
 #pragma once
 
+#include <algorithm>
+#include <limits>
 #include <numeric>
+#include <string>
 #include <type_traits>
 
+#include "../common/array.hpp"
 #include "../common/tuple_util.hpp"
 #include "../meta.hpp"
 #include "../sid/unknown_kind.hpp"
@@ -84,6 +88,51 @@ namespace gridtools {
                 return storage_allocate(Traits(), meta::lazy::id<T>(), size);
             }
 
+            template <class Traits, class T, class = void>
+            struct has_named_allocate : std::false_type {};
+
+            template <class Traits, class T>
+            struct has_named_allocate<Traits,
+                T,
+                std::void_t<decltype(storage_allocate(
+                    std::declval<Traits>(), meta::lazy::id<T>(), size_t(), std::declval<std::string const &>()))>>
+                : std::true_type {};
+
+            /**
+             *  Traits may also customize the allocation of a named storage with
+             *  `storage_allocate(Traits, LazyType, size_t size, std::string const &name)`, which must return the same
+             *  type as the unnamed version.
+             */
+            template <class Traits, class T>
+            auto allocate(size_t size, std::string const &name) {
+                if constexpr (has_named_allocate<Traits, T>::value)
+                    return storage_allocate(Traits(), meta::lazy::id<T>(), size, name);
+                else
+                    return allocate<Traits, T>(size);
+            }
+
+            template <class Traits, class T, class = void>
+            struct has_allocate_for_overwrite : std::false_type {};
+
+            template <class Traits, class T>
+            struct has_allocate_for_overwrite<Traits,
+                T,
+                std::void_t<decltype(storage_allocate_for_overwrite(
+                    std::declval<Traits>(), meta::lazy::id<T>(), size_t()))>> : std::true_type {};
+
+            /**
+             *  Allocation of a storage that is filled by an initializer right away. Traits may provide
+             *  `storage_allocate_for_overwrite(Traits, LazyType, size_t size)`, which must return the same type as
+             *  `storage_allocate`, to skip the initialization done by `storage_allocate`.
+             */
+            template <class Traits, class T>
+            auto allocate_for_overwrite(size_t size, std::string const &name) {
+                if constexpr (has_allocate_for_overwrite<Traits, T>::value)
+                    return storage_allocate_for_overwrite(Traits(), meta::lazy::id<T>(), size);
+                else
+                    return allocate<Traits, T>(size, name);
+            }
+
             template <class Traits, class T>
             using target_ptr_type = decltype(allocate<Traits, T>(0));
 
@@ -106,6 +155,107 @@ namespace gridtools {
             auto make_target_view(T *ptr, Info const &info) {
                 return storage_make_target_view(Traits(), ptr, info);
             }
+
+            /**
+             *  The blocks in which the storage is initialized (and thereby first touched): a block size per dimension,
+             *  zero meaning the full dimension. The blocks are enumerated with the first dimension outermost and are
+             *  distributed over the threads like the iterations of an OpenMP loop with static schedule. Traits should
+             *  choose the decomposition that the backend uses for the computation, so that the pages of a storage
+             *  end up on the NUMA node of the threads that later access them.
+             *
+             *  By default, the storage is split into single slices along the outermost dimension in memory, which
+             *  distributes the memory over the threads like a flat loop.
+             */
+            template <class Traits, size_t Dims>
+            array<int, Dims> storage_init_block_sizes(Traits, std::integral_constant<size_t, Dims>) {
+                array<int, Dims> res = {};
+                constexpr size_t outer = layout_type<Traits, Dims>::find(0);
+                if (outer < Dims)
+                    res[outer] = 1;
+                return res;
+            }
+
+            /**
+             *  Calls `f(indices, index)` for all indices of the box, where `index` is the linear index given by the
+             *  strides. The dimensions are traversed in the order of the strides, the one with the smallest stride
+             *  innermost, and the linear index is updated incrementally.
+             */
+            template <size_t N, class F>
+            void for_each_index_in_box(
+                array<int, N> const &begin, array<int, N> const &end, array<int, N> const &strides, F const &f) {
+                for (size_t d = 0; d != N; ++d)
+                    if (begin[d] >= end[d])
+                        return;
+                // from the outermost to the innermost dimension, masked dimensions (zero stride) are outermost
+                auto key = [&](size_t d) { return strides[d] == 0 ? std::numeric_limits<int>::max() : strides[d]; };
+                array<size_t, N> order;
+                std::iota(order.begin(), order.end(), 0);
+                std::stable_sort(order.begin(), order.end(), [&](size_t l, size_t r) { return key(l) > key(r); });
+                size_t inner = order[N - 1];
+                int inner_begin = begin[inner];
+                int inner_end = end[inner];
+                int inner_stride = strides[inner];
+                auto indices = begin;
+                int index = 0;
+                for (size_t d = 0; d != N; ++d)
+                    index += begin[d] * strides[d];
+                while (true) {
+                    int i = inner_begin;
+                    for (int offset = index; i != inner_end; ++i, offset += inner_stride) {
+                        indices[inner] = i;
+                        f(indices, offset);
+                    }
+                    size_t o = N - 1;
+                    for (; o != 0; --o) {
+                        size_t d = order[o - 1];
+                        if (++indices[d] != end[d]) {
+                            index += strides[d];
+                            break;
+                        }
+                        index -= (end[d] - 1 - begin[d]) * strides[d];
+                        indices[d] = begin[d];
+                    }
+                    if (o == 0)
+                        return;
+                }
+            }
+
+            /**
+             *  Calls `f(indices, index)` for every element of the storage in parallel, following the decomposition of
+             *  `storage_init_block_sizes`, where `index` is the linear index of `indices`. Within a block, the elements
+             *  are visited in memory order. Masked dimensions are visited only at their last index.
+             */
+            template <class Traits, class Info, class F>
+            void init_loop(Info const &info, F const &f) {
+                constexpr size_t n = Info::ndims;
+                if (info.length() == 0)
+                    return;
+                auto block_sizes = storage_init_block_sizes(Traits(), std::integral_constant<size_t, n>());
+                auto lengths = info.lengths();
+                array<int, n> begin, end, num_blocks, strides;
+                int total_blocks = 1;
+                for (size_t d = 0; d != n; ++d) {
+                    strides[d] = info.strides()[d];
+                    begin[d] = strides[d] == 0 ? lengths[d] - 1 : 0;
+                    end[d] = lengths[d];
+                    int size = end[d] - begin[d];
+                    if (block_sizes[d] <= 0 || block_sizes[d] > size)
+                        block_sizes[d] = size;
+                    num_blocks[d] = (size + block_sizes[d] - 1) / block_sizes[d];
+                    total_blocks *= num_blocks[d];
+                }
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+                for (int block = 0; block < total_blocks; ++block) {
+                    array<int, n> block_begin, block_end;
+                    for (int d = n - 1, rest = block; d >= 0; rest /= num_blocks[d], --d) {
+                        block_begin[d] = begin[d] + rest % num_blocks[d] * block_sizes[d];
+                        block_end[d] = std::min(block_begin[d] + block_sizes[d], end[d]);
+                    }
+                    for_each_index_in_box(block_begin, block_end, strides, f);
+                }
+            }
         } // namespace traits
     }     // namespace storage
 } // namespace gridtools
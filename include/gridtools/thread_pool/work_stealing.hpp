@@ -0,0 +1,289 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include "../common/integral_constant.hpp"
+
+namespace gridtools {
+    namespace thread_pool {
+        namespace work_stealing_impl_ {
+            // number of polls of an idle worker before it goes to sleep
+            constexpr int spin_count = 1 << 14;
+
+            inline std::vector<int> available_cpus() {
+                std::vector<int> res;
+#ifdef __linux__
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                if (sched_getaffinity(0, sizeof(set), &set) == 0)
+                    for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+                        if (CPU_ISSET(cpu, &set))
+                            res.push_back(cpu);
+#endif
+                return res;
+            }
+
+            inline void pin_current_thread(int cpu) {
+#ifdef __linux__
+                cpu_set_t set;
+                CPU_ZERO(&set);
+                CPU_SET(cpu, &set);
+                pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+#endif
+            }
+
+            inline int &current_thread_num() {
+                thread_local int res = 0;
+                return res;
+            }
+
+            inline bool &inside_loop() {
+                thread_local bool res = false;
+                return res;
+            }
+
+            /*
+             *  The iterations of a loop that are not yet taken by any worker. The owner pops single iterations
+             *  from the front, thieves take the back half.
+             */
+            struct alignas(64) range_deque {
+                std::mutex m_mutex;
+                std::size_t m_begin = 0;
+                std::size_t m_end = 0;
+
+                bool pop_front(std::size_t &res) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_begin == m_end)
+                        return false;
+                    res = m_begin++;
+                    return true;
+                }
+
+                bool steal_back(std::size_t &begin, std::size_t &end) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    if (m_begin == m_end)
+                        return false;
+                    end = m_end;
+                    begin = m_end -= (m_end - m_begin + 1) / 2;
+                    return true;
+                }
+
+                void reset(std::size_t begin, std::size_t end) {
+                    std::lock_guard<std::mutex> lock(m_mutex);
+                    m_begin = begin;
+                    m_end = end;
+                }
+            };
+
+            /*
+             *  Process-wide set of persistent workers.
+             *
+             *  The thread that calls `parallel_for` takes part in the loop as worker 0, the other workers are
+             *  started on first use and pinned to the CPUs of the process affinity mask. The number of workers
+             *  defaults to the number of those CPUs and can be set with the environment variable
+             *  GT_WORK_STEALING_THREADS; pinning can be disabled with GT_WORK_STEALING_PIN=0.
+             *
+             *  Loops that are started from within a loop, or while another thread runs a loop, are executed
+             *  serially by the calling thread.
+             */
+            class pool {
+                using task_f = void (*)(void const *, std::size_t);
+
+                int m_num_threads;
+                std::unique_ptr<range_deque[]> m_deques;
+                std::vector<std::thread> m_workers;
+
+                std::mutex m_loop_mutex;
+                task_f m_task = nullptr;
+                void const *m_task_data = nullptr;
+                std::atomic<std::size_t> m_generation{0};
+                std::atomic<int> m_busy{0};
+                std::atomic<bool> m_stop{false};
+                std::mutex m_sleep_mutex;
+                std::condition_variable m_wake_up;
+
+                static int num_threads_from_env(std::vector<int> const &cpus) {
+                    if (char const *env = std::getenv("GT_WORK_STEALING_THREADS")) {
+                        int res = std::atoi(env);
+                        if (res > 0)
+                            return res;
+                    }
+                    if (!cpus.empty())
+                        return cpus.size();
+                    return std::max(1u, std::thread::hardware_concurrency());
+                }
+
+                static bool pinning_from_env() {
+                    char const *env = std::getenv("GT_WORK_STEALING_PIN");
+                    return !env || std::atoi(env) != 0;
+                }
+
+                void execute(int id) {
+                    inside_loop() = true;
+                    std::size_t index;
+                    while (true) {
+                        while (m_deques[id].pop_front(index))
+                            m_task(m_task_data, index);
+                        std::size_t begin, end;
+                        bool stolen = false;
+                        for (int i = 1; i < m_num_threads && !stolen; ++i)
+                            stolen = m_deques[(id + i) % m_num_threads].steal_back(begin, end);
+                        if (!stolen)
+                            break;
+                        m_deques[id].reset(begin + 1, end);
+                        m_task(m_task_data, begin);
+                    }
+                    inside_loop() = false;
+                }
+
+                void worker(int id, int cpu) {
+                    current_thread_num() = id;
+                    if (cpu >= 0)
+                        pin_current_thread(cpu);
+                    std::size_t generation = 0;
+                    while (true) {
+                        for (int i = 0; i < spin_count && m_generation.load(std::memory_order_acquire) == generation;
+                             ++i)
+                            std::this_thread::yield();
+                        if (m_generation.load(std::memory_order_acquire) == generation) {
+                            std::unique_lock<std::mutex> lock(m_sleep_mutex);
+                            m_wake_up.wait(lock, [&] { return m_stop || m_generation.load() != generation; });
+                        }
+                        if (m_stop)
+                            return;
+                        generation = m_generation.load(std::memory_order_acquire);
+                        execute(id);
+                        m_busy.fetch_sub(1, std::memory_order_release);
+                    }
+                }
+
+                pool() {
+                    auto cpus = available_cpus();
+                    m_num_threads = num_threads_from_env(cpus);
+                    m_deques.reset(new range_deque[m_num_threads]);
+                    bool pin = pinning_from_env() && !cpus.empty();
+                    for (int id = 1; id < m_num_threads; ++id)
+                        m_workers.emplace_back(&pool::worker, this, id, pin ? cpus[id % cpus.size()] : -1);
+                }
+
+              public:
+                pool(pool const &) = delete;
+                pool &operator=(pool const &) = delete;
+
+                ~pool() {
+                    {
+                        std::lock_guard<std::mutex> lock(m_sleep_mutex);
+                        m_stop = true;
+                    }
+                    m_wake_up.notify_all();
+                    for (auto &worker : m_workers)
+                        worker.join();
+                }
+
+                static pool &instance() {
+                    static pool res;
+                    return res;
+                }
+
+                int num_threads() const { return m_num_threads; }
+
+                template <class F>
+                void parallel_for(F const &f, std::size_t size) {
+                    std::unique_lock<std::mutex> lock;
+                    if (!inside_loop())
+                        lock = std::unique_lock<std::mutex>(m_loop_mutex, std::try_to_lock);
+                    if (!lock || m_num_threads == 1 || size < 2) {
+                        for (std::size_t i = 0; i != size; ++i)
+                            f(i);
+                        return;
+                    }
+                    m_task = [](void const *data, std::size_t i) { (*static_cast<F const *>(data))(i); };
+                    m_task_data = &f;
+                    for (int id = 0; id < m_num_threads; ++id)
+                        m_deques[id].reset(size * id / m_num_threads, size * (id + 1) / m_num_threads);
+                    m_busy.store(m_num_threads - 1, std::memory_order_relaxed);
+                    {
+                        std::lock_guard<std::mutex> sleep_lock(m_sleep_mutex);
+                        m_generation.fetch_add(1, std::memory_order_release);
+                    }
+                    m_wake_up.notify_all();
+                    execute(0);
+                    while (m_busy.load(std::memory_order_acquire))
+                        std::this_thread::yield();
+                }
+            };
+        } // namespace work_stealing_impl_
+
+        /**
+         *  Thread pool of persistent (and by default pinned) workers that balance the load of a loop by stealing
+         *  iterations from each other.
+         *
+         *  Each worker starts with a contiguous chunk of the iteration space; a worker that runs out of iterations
+         *  takes the back half of the remaining iterations of another worker.
+         */
+        struct work_stealing {
+            friend int thread_pool_get_thread_num(work_stealing) { return work_stealing_impl_::current_thread_num(); }
+            friend int thread_pool_get_max_threads(work_stealing) {
+                return work_stealing_impl_::pool::instance().num_threads();
+            }
+
+            template <class F, class I>
+            friend void thread_pool_parallel_for_loop(work_stealing, F const &f, I lim) {
+                using i_t = to_integral_type_t<I>;
+                if (lim <= 0)
+                    return;
+                work_stealing_impl_::pool::instance().parallel_for([&](std::size_t index) { f((i_t)index); }, lim);
+            }
+
+            template <class F, class I, class J, class I_t = to_integral_type_t<I>, class J_t = to_integral_type_t<J>>
+            friend void thread_pool_parallel_for_loop(work_stealing, F const &f, I i_lim, J j_lim) {
+                if (i_lim <= 0 || j_lim <= 0)
+                    return;
+                std::size_t i_size = i_lim;
+                work_stealing_impl_::pool::instance().parallel_for(
+                    [&](std::size_t index) { f(I_t(index % i_size), J_t(index / i_size)); }, i_size * j_lim);
+            }
+
+            template <class F,
+                class I,
+                class J,
+                class K,
+                class I_t = to_integral_type_t<I>,
+                class J_t = to_integral_type_t<J>,
+                class K_t = to_integral_type_t<K>>
+            friend void thread_pool_parallel_for_loop(work_stealing, F const &f, I i_lim, J j_lim, K k_lim) {
+                if (i_lim <= 0 || j_lim <= 0 || k_lim <= 0)
+                    return;
+                std::size_t i_size = i_lim;
+                std::size_t j_size = j_lim;
+                work_stealing_impl_::pool::instance().parallel_for(
+                    [&](std::size_t index) {
+                        f(I_t(index % i_size), J_t(index / i_size % j_size), K_t(index / i_size / j_size));
+                    },
+                    i_size * j_size * k_lim);
+            }
+        };
+    } // namespace thread_pool
+} // namespace gridtools
@@ -28,6 +28,45 @@
 namespace {
     using fn_backend_t = gridtools::fn::backend::naive;
 }
+#elif defined(GT_FN_CPU_BLOCKED) || defined(GT_FN_CPU_BLOCKED_SIMD) || defined(GT_FN_CPU_BLOCKED_KFIRST)
+#ifndef GT_STENCIL_CPU_IFIRST
+#define GT_STENCIL_CPU_IFIRST
+#endif
+#ifdef GT_FN_CPU_BLOCKED_KFIRST
+#ifndef GT_STORAGE_CPU_KFIRST
+#define GT_STORAGE_CPU_KFIRST
+#endif
+#elif !defined(GT_STORAGE_CPU_IFIRST)
+#define GT_STORAGE_CPU_IFIRST
+#endif
+#ifndef GT_TIMER_OMP
+#define GT_TIMER_OMP
+#endif
+#include <gridtools/fn/backend/cpu_blocked.hpp>
+#ifdef GT_FN_CPU_BLOCKED_KFIRST
+#include <gridtools/fn/unstructured.hpp>
+#endif
+namespace {
+    template <int... sizes>
+    using block_sizes_t =
+        gridtools::meta::zip<gridtools::meta::iseq_to_list<std::make_integer_sequence<int, sizeof...(sizes)>,
+                                 gridtools::meta::list,
+                                 gridtools::integral_constant>,
+            gridtools::meta::list<gridtools::integral_constant<int, sizes>...>>;
+
+#ifdef GT_FN_CPU_BLOCKED_SIMD
+    using fn_backend_t = gridtools::fn::backend::
+        cpu_blocked<block_sizes_t<64, 8>, gridtools::thread_pool::omp, gridtools::integral_constant<int, 8>>;
+#elif defined(GT_FN_CPU_BLOCKED_KFIRST)
+    // for unstructured fields with a vertical-contiguous layout: whole columns are the innermost loop
+    using fn_backend_t = gridtools::fn::backend::cpu_blocked<block_sizes_t<8>,
+        gridtools::thread_pool::omp,
+        gridtools::integral_constant<int, 1>,
+        gridtools::fn::unstructured::dim::vertical>;
+#else
+    using fn_backend_t = gridtools::fn::backend::cpu_blocked<block_sizes_t<64, 8>>;
+#endif
+} // namespace
 #elif defined(GT_FN_GPU)
 #ifndef GT_STENCIL_GPU
 #define GT_STENCIL_GPU
@@ -69,6 +108,23 @@ namespace gridtools::fn::backend {
         }
     } // namespace naive_impl_
 
+    namespace cpu_blocked_impl_ {
+        template <class, class, class, class>
+        struct cpu_blocked;
+        template <class BlockSizes, class ThreadPool, class SimdWidth, class InnerDim>
+        std::conditional_t<std::is_void_v<InnerDim>, storage::cpu_ifirst, storage::cpu_kfirst> backend_storage_traits(
+            cpu_blocked<BlockSizes, ThreadPool, SimdWidth, InnerDim>);
+        template <class BlockSizes, class ThreadPool, class SimdWidth, class InnerDim>
+        timer_omp backend_timer_impl(cpu_blocked<BlockSizes, ThreadPool, SimdWidth, InnerDim>);
+        template <class BlockSizes, class ThreadPool, class SimdWidth, class InnerDim>
+        inline char const *backend_name(cpu_blocked<BlockSizes, ThreadPool, SimdWidth, InnerDim> const &) {
+            if constexpr (!std::is_void_v<InnerDim>)
+                return "cpu_blocked_kfirst";
+            else
+                return SimdWidth::value > 1 ? "cpu_blocked_simd" : "cpu_blocked";
+        }
+    } // namespace cpu_blocked_impl_
+
     namespace gpu_impl_ {
         template <class>
         struct gpu;
@@ -42,6 +42,20 @@ namespace {
 namespace {
     using reduction_backend_t = gridtools::reduction::cpu;
 }
+#elif defined(GT_REDUCTION_CPU_DETERMINISTIC)
+#ifndef GT_STENCIL_CPU_IFIRST
+#define GT_STENCIL_CPU_IFIRST
+#endif
+#ifndef GT_STORAGE_CPU_IFIRST
+#define GT_STORAGE_CPU_IFIRST
+#endif
+#ifndef GT_TIMER_OMP
+#define GT_TIMER_OMP
+#endif
+#include <gridtools/reduction/cpu_deterministic.hpp>
+namespace {
+    using reduction_backend_t = gridtools::reduction::cpu_deterministic<>;
+}
 #elif defined(GT_REDUCTION_GPU)
 #ifndef GT_STENCIL_GPU
 #define GT_STENCIL_GPU
@@ -74,6 +88,17 @@ namespace gridtools {
         timer_omp backend_timer_impl(cpu);
         inline char const *backend_name(cpu const &) { return "cpu"; }
 
+        template <bool>
+        struct cpu_deterministic;
+        template <bool Compensated>
+        storage::cpu_ifirst backend_storage_traits(cpu_deterministic<Compensated>);
+        template <bool Compensated>
+        timer_omp backend_timer_impl(cpu_deterministic<Compensated>);
+        template <bool Compensated>
+        char const *backend_name(cpu_deterministic<Compensated> const &) {
+            return Compensated ? "cpu_compensated" : "cpu_deterministic";
+        }
+
         namespace gpu_backend {
             struct gpu;
             storage::gpu backend_storage_traits(gpu);
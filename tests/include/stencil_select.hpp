@@ -41,6 +41,20 @@ namespace {
         gridtools::integral_constant<int, 8>,
         gridtools::thread_pool::hpx>;
 }
+#elif defined(GT_STENCIL_CPU_KFIRST_WORK_STEALING)
+#ifndef GT_STORAGE_CPU_KFIRST
+#define GT_STORAGE_CPU_KFIRST
+#endif
+#ifndef GT_TIMER_OMP
+#define GT_TIMER_OMP
+#endif
+#include <gridtools/stencil/cpu_kfirst.hpp>
+#include <gridtools/thread_pool/work_stealing.hpp>
+namespace {
+    using stencil_backend_t = gridtools::stencil::cpu_kfirst<gridtools::integral_constant<int, 8>,
+        gridtools::integral_constant<int, 8>,
+        gridtools::thread_pool::work_stealing>;
+}
 #elif defined(GT_STENCIL_NAIVE)
 #ifndef GT_STORAGE_CPU_KFIRST
 #define GT_STORAGE_CPU_KFIRST
@@ -77,6 +91,30 @@ namespace {
 namespace {
     using stencil_backend_t = gridtools::stencil::cpu_ifirst<gridtools::thread_pool::hpx>;
 }
+#elif defined(GT_STENCIL_CPU_IFIRST_WORK_STEALING)
+#ifndef GT_STORAGE_CPU_IFIRST
+#define GT_STORAGE_CPU_IFIRST
+#endif
+#ifndef GT_TIMER_OMP
+#define GT_TIMER_OMP
+#endif
+#include <gridtools/stencil/cpu_ifirst.hpp>
+#include <gridtools/thread_pool/work_stealing.hpp>
+namespace {
+    using stencil_backend_t = gridtools::stencil::cpu_ifirst<gridtools::thread_pool::work_stealing>;
+}
+#elif defined(GT_STENCIL_CPU_IFIRST_SIMD)
+#ifndef GT_STORAGE_CPU_IFIRST
+#define GT_STORAGE_CPU_IFIRST
+#endif
+#ifndef GT_TIMER_OMP
+#define GT_TIMER_OMP
+#endif
+#include <gridtools/stencil/cpu_ifirst.hpp>
+namespace {
+    using stencil_backend_t =
+        gridtools::stencil::cpu_ifirst<gridtools::thread_pool::omp, gridtools::integral_constant<gridtools::int_t, 8>>;
+}
 #elif defined(GT_STENCIL_GPU)
 #ifndef GT_STORAGE_GPU
 #define GT_STORAGE_GPU
@@ -165,23 +203,30 @@ namespace gridtools {
                 hpx_stop();
             }
 #endif
+
+#if defined(GT_STENCIL_CPU_KFIRST_WORK_STEALING)
+            template <class I, class J>
+            char const *backend_name(cpu_kfirst<I, J, thread_pool::work_stealing> const &) {
+                return "cpu_kfirst_work_stealing";
+            }
+#endif
         } // namespace cpu_kfirst_backend
 
         namespace cpu_ifirst_backend {
-            template <class>
+            template <class, class>
             struct cpu_ifirst;
 
-            template <class T>
-            storage::cpu_ifirst backend_storage_traits(cpu_ifirst<T>);
+            template <class T, class W>
+            storage::cpu_ifirst backend_storage_traits(cpu_ifirst<T, W>);
 
-            template <class T>
-            std::false_type backend_supports_icosahedral(cpu_ifirst<T>);
+            template <class T, class W>
+            std::false_type backend_supports_icosahedral(cpu_ifirst<T, W>);
 
-            template <class T>
-            timer_omp backend_timer_impl(cpu_ifirst<T>);
+            template <class T, class W>
+            timer_omp backend_timer_impl(cpu_ifirst<T, W>);
 
-            template <class T>
-            char const *backend_name(cpu_ifirst<T> const &) {
+            template <class T, class W>
+            char const *backend_name(cpu_ifirst<T, W> const &) {
                 return "cpu_ifirst";
             }
 
@@ -192,6 +237,18 @@ namespace gridtools {
 
             inline void backend_finalize(cpu_ifirst<thread_pool::hpx>) { hpx_stop(); }
 #endif
+
+#if defined(GT_STENCIL_CPU_IFIRST_WORK_STEALING)
+            inline char const *backend_name(cpu_ifirst<thread_pool::work_stealing> const &) {
+                return "cpu_ifirst_work_stealing";
+            }
+#endif
+
+#if defined(GT_STENCIL_CPU_IFIRST_SIMD)
+            inline char const *backend_name(cpu_ifirst<thread_pool::omp, integral_constant<int_t, 8>> const &) {
+                return "cpu_ifirst_simd";
+            }
+#endif
         } // namespace cpu_ifirst_backend
 
         namespace gpu_backend {
@@ -10,6 +10,7 @@
 
 #include <gtest/gtest.h>
 
+#include <gridtools/sid/widen.hpp>
 #include <gridtools/stencil/cartesian.hpp>
 
 #include <stencil_select.hpp>
@@ -42,4 +43,18 @@ namespace {
         TypeParam::verify(in, out);
         TypeParam::benchmark("copy_stencil", comp);
     }
+
+    // the fields are stored in single precision, the computation is done in `float_t`
+    GT_REGRESSION_TEST(copy_stencil_reduced_precision, test_environment<>, stencil_backend_t) {
+        using float_t = typename TypeParam::float_t;
+        auto in = [](int i, int j, int k) { return i + j + k; };
+        auto out = TypeParam::template make_storage<float>();
+        auto comp = [&out, grid = TypeParam::make_grid(), in = TypeParam::template make_const_storage<float>(in)] {
+            run_single_stage(
+                copy_functor(), stencil_backend_t(), grid, sid::widen<float_t>(in), sid::widen<float_t>(out));
+        };
+        comp();
+        TypeParam::verify(in, out);
+        TypeParam::benchmark("copy_stencil_reduced_precision", comp);
+    }
 } // namespace
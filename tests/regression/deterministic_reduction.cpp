@@ -0,0 +1,89 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include <omp.h>
+
+#include <gridtools/reduction.hpp>
+#include <gridtools/reduction/cpu.hpp>
+#include <gridtools/stencil/cartesian.hpp>
+
+#include <reduction_select.hpp>
+#include <test_environment.hpp>
+
+namespace {
+    using namespace gridtools;
+    using namespace stencil;
+    using namespace cartesian;
+
+    struct copy_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1>;
+
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    // sums `data` after copying it into a reducible with a stencil
+    template <class Backend, class Env, class Data>
+    auto make_sum(Data const &data) {
+        using float_t = typename Env::float_t;
+        auto out = reduction::make_reducible<Backend, storage_traits_t>(float_t(0), Env::d(0), Env::d(1), Env::d(2));
+        auto in = Env::make_const_storage(
+            [&](int i, int j, int k) { return data[(k * Env::d(1) + j) * Env::d(0) + i]; });
+        run_single_stage(copy_functor(), stencil_backend_t(), Env::make_grid(), out, in);
+        return [out] { return out.reduce(reduction::plus()); };
+    }
+
+    template <class Sum>
+    void expect_thread_count_independent(Sum const &sum) {
+        int max_threads = omp_get_max_threads();
+        omp_set_num_threads(1);
+        auto expected = sum();
+        for (int num_threads : {2, 3, 7}) {
+            omp_set_num_threads(num_threads);
+            EXPECT_EQ(sum(), expected) << num_threads << " threads";
+        }
+        omp_set_num_threads(max_threads);
+    }
+
+    GT_REGRESSION_TEST(deterministic_reduction, test_environment<>, reduction_backend_t) {
+        using float_t = typename TypeParam::float_t;
+        size_t size = TypeParam::d(0) * TypeParam::d(1) * TypeParam::d(2);
+        std::vector<float_t> data(size);
+        std::mt19937 gen(42);
+        std::uniform_real_distribution<double> dist(-1, 1);
+        long double exact = 0;
+        for (auto &val : data) {
+            val = dist(gen) * std::exp2(40 * dist(gen));
+            exact += val;
+        }
+
+        auto sum = make_sum<reduction_backend_t, TypeParam>(data);
+        auto compensated_sum = make_sum<reduction::cpu_deterministic<true>, TypeParam>(data);
+        expect_thread_count_independent(sum);
+        expect_thread_count_independent(compensated_sum);
+        EXPECT_LE(std::abs(compensated_sum() - exact), std::abs(sum() - exact));
+
+        auto omp_sum = make_sum<reduction::cpu, TypeParam>(data);
+        TypeParam::benchmark("sum_omp", omp_sum);
+        TypeParam::benchmark("sum_deterministic", sum);
+        TypeParam::benchmark("sum_compensated", compensated_sum);
+    }
+} // namespace
@@ -115,6 +115,7 @@ namespace {
         };
         comp();
         TypeParam::verify(expected, x);
+        TypeParam::benchmark("fn_cartesian_tridiagonal_solve", comp);
     }
 
     GT_REGRESSION_TEST(fn_unstructured_tridiagonal_solve, vertical_test_environment<>, fn_backend_t) {
@@ -8,8 +8,16 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <utility>
+#include <vector>
+
 #include <gtest/gtest.h>
 
+#include <gridtools/fn/delta_neighbor_table.hpp>
+#include <gridtools/fn/renumbering.hpp>
 #include <gridtools/fn/sid_neighbor_table.hpp>
 #include <gridtools/fn/unstructured.hpp>
 #include <gridtools/sid/dimension_to_tuple_like.hpp>
@@ -237,6 +245,129 @@ namespace {
         };
     };
 
+    // the neighbor tables as SIDs
+    struct sid_tables {
+        template <class Mesh, class V2E, class E2V>
+        auto operator()(Mesh const &, V2E const &v2e_table, E2V const &e2v_table) const {
+            auto v2e_ptr = sid_neighbor_table::as_neighbor_table<integral_constant<int, 0>,
+                integral_constant<int, 1>,
+                Mesh::max_v2e_neighbors_t::value>(v2e_table);
+            auto e2v_ptr = sid_neighbor_table::as_neighbor_table<integral_constant<int, 0>,
+                integral_constant<int, 1>,
+                Mesh::max_e2v_neighbors_t::value>(e2v_table);
+            return tuple(v2e_ptr, e2v_ptr);
+        }
+    };
+
+    // the neighbor tables compressed to 16 bit deltas
+    struct delta_tables {
+        template <class Mesh, class V2E, class E2V>
+        auto operator()(Mesh const &mesh, V2E const &v2e_table, E2V const &e2v_table) const {
+            using delta_neighbor_table::make_delta_neighbor_table;
+            return tuple(make_delta_neighbor_table<Mesh::max_v2e_neighbors_t::value>(
+                             v2e_table->const_host_view(), mesh.nedges()),
+                make_delta_neighbor_table<Mesh::max_e2v_neighbors_t::value>(
+                    e2v_table->const_host_view(), mesh.nvertices()));
+        }
+    };
+
+    // the mesh with all locations numbered by `vperm` and `eperm`, the fields are initialized at the old indices
+    constexpr inline auto make_comp_renumbered = [](auto backend,
+                                                     auto const &mesh,
+                                                     auto &nabla,
+                                                     renumbering::permutation const &vperm,
+                                                     renumbering::permutation const &eperm,
+                                                     auto make_tables) {
+        using mesh_t = std::remove_reference_t<decltype(mesh)>;
+        auto v2e_table = mesh.template make_storage<int>(mesh.nvertices(), mesh_t::max_v2e_neighbors_t::value);
+        auto e2v_table = mesh.template make_storage<int>(mesh.nedges(), mesh_t::max_e2v_neighbors_t::value);
+        renumbering::permute_table(vperm, eperm, mesh.v2e_table()->const_host_view(), v2e_table->host_view());
+        renumbering::permute_table(eperm, vperm, mesh.e2v_table()->const_host_view(), e2v_table->host_view());
+        auto on_vertices = [&](auto f) {
+            return [f, &vperm](int v, auto... k) { return f(vperm.new_to_old(v), k...); };
+        };
+        auto on_edges = [&](auto f) {
+            return [f, &eperm](int e, auto... k) { return f(eperm.new_to_old(e), k...); };
+        };
+        return [backend,
+                   &nabla,
+                   nvertices = mesh.nvertices(),
+                   nedges = mesh.nedges(),
+                   nlevels = mesh.nlevels(),
+                   v2e_table,
+                   e2v_table,
+                   tables = make_tables(mesh, v2e_table, e2v_table),
+                   pp = mesh.make_const_storage(on_vertices(pp), mesh.nvertices(), mesh.nlevels()),
+                   sign = mesh.template make_const_storage<array<float_t, 6>>(on_vertices(sign), mesh.nvertices()),
+                   vol = mesh.make_const_storage(on_vertices(vol), mesh.nvertices()),
+                   s = mesh.template make_const_storage<tuple<float_t, float_t>>(
+                       on_edges(s), mesh.nedges(), mesh.nlevels())] {
+            fencil(backend, nvertices, nedges, nlevels, get<0>(tables), get<1>(tables), nabla, pp, s, sign, vol);
+        };
+    };
+
+    inline renumbering::permutation shuffled(int size) {
+        std::vector<int> order(size);
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), std::mt19937(42));
+        return renumbering::permutation(std::move(order));
+    }
+
+    // runs nabla on the mesh numbered by `vperm` and `eperm` and verifies the result in the original numbering
+    template <class TypeParam, class MakeTables = sid_tables>
+    void run_renumbered(char const *name,
+        renumbering::permutation const &vperm,
+        renumbering::permutation const &eperm,
+        MakeTables make_tables = {}) {
+        using float_t = typename TypeParam::float_t;
+
+        auto mesh = TypeParam::fn_unstructured_mesh();
+        auto nabla = mesh.template make_storage<tuple<float_t, float_t>>(mesh.nvertices(), mesh.nlevels());
+        auto comp = make_comp_renumbered(fn_backend_t(), mesh, nabla, vperm, eperm, make_tables);
+        comp();
+        auto nabla_out = mesh.template make_storage<tuple<float_t, float_t>>(mesh.nvertices(), mesh.nlevels());
+        renumbering::permute_field(renumbering::inverse(vperm), nabla->const_host_view(), nabla_out->host_view());
+        auto expected = make_expected(mesh);
+        TypeParam::verify(expected, nabla_out);
+        TypeParam::benchmark(name, comp);
+    }
+
+    // the mesh with randomly numbered vertices and edges, as for meshes from generators with poor locality
+    GT_REGRESSION_TEST(fn_unstructured_nabla_shuffled, test_environment<>, fn_backend_t) {
+        auto mesh = TypeParam::fn_unstructured_mesh();
+        run_renumbered<TypeParam>(
+            "fn_unstructured_nabla_shuffled", shuffled(mesh.nvertices()), shuffled(mesh.nedges()));
+    }
+
+    // the vertex and edge permutations that renumber the shuffled mesh with reverse Cuthill-McKee
+    template <class Mesh>
+    auto renumbered_permutations(Mesh const &mesh) {
+        auto vshuffle = shuffled(mesh.nvertices());
+        auto eshuffle = shuffled(mesh.nedges());
+        auto v2e = mesh.template make_storage<int>(mesh.nvertices(), Mesh::max_v2e_neighbors_t::value);
+        auto e2v = mesh.template make_storage<int>(mesh.nedges(), Mesh::max_e2v_neighbors_t::value);
+        renumbering::permute_table(vshuffle, eshuffle, mesh.v2e_table()->const_host_view(), v2e->host_view());
+        renumbering::permute_table(eshuffle, vshuffle, mesh.e2v_table()->const_host_view(), e2v->host_view());
+        auto vrcm = renumbering::reverse_cuthill_mckee(
+            renumbering::make_adjacency(v2e->const_host_view(), e2v->const_host_view()));
+        auto ercm = renumbering::induced_permutation(e2v->const_host_view(), vrcm);
+        return std::pair(renumbering::compose(vshuffle, vrcm), renumbering::compose(eshuffle, ercm));
+    }
+
+    // the shuffled mesh renumbered with reverse Cuthill-McKee
+    GT_REGRESSION_TEST(fn_unstructured_nabla_renumbered, test_environment<>, fn_backend_t) {
+        auto [vperm, eperm] = renumbered_permutations(TypeParam::fn_unstructured_mesh());
+        run_renumbered<TypeParam>("fn_unstructured_nabla_renumbered", vperm, eperm);
+    }
+
+#ifndef GT_FN_GPU
+    // as above, with compressed neighbor tables (host memory only)
+    GT_REGRESSION_TEST(fn_unstructured_nabla_renumbered_delta_table, test_environment<>, fn_backend_t) {
+        auto [vperm, eperm] = renumbered_permutations(TypeParam::fn_unstructured_mesh());
+        run_renumbered<TypeParam>("fn_unstructured_nabla_renumbered_delta_table", vperm, eperm, delta_tables());
+    }
+#endif
+
     GT_REGRESSION_TEST(fn_unstructured_nabla_field_of_tuples, test_environment<>, fn_backend_t) {
         using float_t = typename TypeParam::float_t;
 
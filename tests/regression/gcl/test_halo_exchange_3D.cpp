@@ -77,6 +77,7 @@ class halo_exchange_3D_test : public testing::TestWithParam<test_spec> {
         return {val(i, 0), val(j, 1), val(k, 2), field_no};
     }
 
+  protected:
     template <int... Is>
     auto make_storages(layout_map<Is...>) const {
         auto make_storage = [&](int field_no) {
@@ -207,6 +208,68 @@ INSTANTIATE_TEST_SUITE_P(tests,
             .halos = {{{2, 2}, {2, 2}, {2, 2}}, {{2, 2}, {2, 2}, {2, 2}}, {{2, 2}, {2, 2}, {2, 2}}},
             .mpi_dims = {2, 1}}));
 
+struct halo_exchange_3D_modes : halo_exchange_3D_test {};
+
+TEST_P(halo_exchange_3D_modes, test) {
+    for (bool use_mpi_datatypes : {false, true}) {
+        if (use_mpi_datatypes && !std::is_same_v<gcl_arch_t, gcl::cpu>)
+            continue;
+        run_exchanges([&](auto layout, auto use_vector_interface, auto &&storages, auto... periodicity) {
+            using testee_t =
+                gcl::halo_exchange_dynamic_ut<decltype(layout), layout_map<0, 1, 2>, value_type, gcl_arch_t>;
+            testee_t testee({periodicity...}, CartComm);
+            auto halo_descriptors = make_halo_descriptors(storages, 0);
+            for_each<meta::make_indices_c<num_fields>>(
+                [&](auto f) { testee.template add_halo<decltype(f)::value>(halo_descriptors[f.value]); });
+            testee.setup(3);
+            testee.use_persistent_requests();
+            if constexpr (std::is_same_v<gcl_arch_t, gcl::cpu>)
+                testee.use_mpi_datatypes(use_mpi_datatypes);
+            auto field = [&](int f) { return storages[f]->get_target_ptr(); };
+            // the requests (and datatypes) are built again for three fields and reused by the last exchange
+            exchange(use_vector_interface, testee, field(0), field(1));
+            exchange(use_vector_interface, testee, field(0), field(1), field(2));
+            exchange(use_vector_interface, testee, field(0), field(1), field(2));
+        });
+    }
+}
+
+TEST_P(halo_exchange_3D_modes, other_fields) {
+    for (bool use_mpi_datatypes : {false, true}) {
+        if (use_mpi_datatypes && !std::is_same_v<gcl_arch_t, gcl::cpu>)
+            continue;
+        run_exchanges([&](auto layout, auto use_vector_interface, auto &&storages, auto... periodicity) {
+            using testee_t =
+                gcl::halo_exchange_dynamic_ut<decltype(layout), layout_map<0, 1, 2>, value_type, gcl_arch_t>;
+            testee_t testee({periodicity...}, CartComm);
+            auto halo_descriptors = make_halo_descriptors(storages, 0);
+            for_each<meta::make_indices_c<num_fields>>(
+                [&](auto f) { testee.template add_halo<decltype(f)::value>(halo_descriptors[f.value]); });
+            testee.setup(3);
+            testee.use_persistent_requests();
+            if constexpr (std::is_same_v<gcl_arch_t, gcl::cpu>)
+                testee.use_mpi_datatypes(use_mpi_datatypes);
+            auto others = make_storages(layout);
+            auto field = [&](int f) { return storages[f]->get_target_ptr(); };
+            auto other = [&](int f) { return others[f]->get_target_ptr(); };
+            // the same number of fields at every exchange, but other fields each time
+            exchange(use_vector_interface, testee, other(0), other(1));
+            exchange(use_vector_interface, testee, field(0), field(1));
+            exchange(use_vector_interface, testee, other(2), field(2));
+            verify(others, {periodicity...});
+        });
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(tests,
+    halo_exchange_3D_modes,
+    testing::Values(test_spec{.dims = {23, 12, 7},
+                        .halos = {{{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}, {{2, 2}, {4, 4}, {3, 3}}},
+                        .mpi_dims = {2, 1}},
+        test_spec{.dims = {12, 12, 12},
+            .halos = {{{2, 2}, {2, 2}, {2, 2}}, {{2, 2}, {2, 2}, {2, 2}}, {{2, 2}, {2, 2}, {2, 2}}},
+            .mpi_dims = {}}));
+
 struct halo_exchange_3D_generic : halo_exchange_3D_test {
     array<halo_descriptor, num_dims> make_enclosed_halo_descriptor() {
         array<halo_descriptor, num_dims> res;
@@ -8,6 +8,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 
+#include <gridtools/sid/widen.hpp>
 #include <gridtools/stencil/cartesian.hpp>
 
 #include <stencil_select.hpp>
@@ -93,12 +94,12 @@ namespace {
     template <class Env,
         std::enable_if_t<
             !meta::is_instantiation_of<gpu_horizontal_backend::gpu_horizontal, typename Env::backend_t>::value,
-            int> = 0>
-    auto get_spec() {
-        return [](auto in, auto coeff, auto out) {
+            int> = 0,
+        class Execution = decltype(execute_parallel())>
+    auto get_spec(Execution execution = {}) {
+        return [execution](auto in, auto coeff, auto out) {
             GT_DECLARE_TMP(typename Env::float_t, lap, flx, fly);
-            return execute_parallel()
-                .ij_cached(lap, flx, fly)
+            return execution.ij_cached(lap, flx, fly)
                 .stage(lap_function(), lap, in)
                 .stage(flx_function(), flx, in, lap)
                 .stage(fly_function(), fly, in, lap)
@@ -133,4 +134,41 @@ namespace {
         TypeParam::verify(repo.out, out);
         TypeParam::benchmark("horizontal_diffusion", comp);
     }
+
+    // the same computation as above, but executed serially along k, where ij-cached temporaries must not be kept for
+    // all k-levels
+    GT_REGRESSION_TEST(horizontal_diffusion_forward, vertical_test_environment<2>, stencil_backend_t) {
+        horizontal_diffusion_repository repo(TypeParam::d(0), TypeParam::d(1), TypeParam::d(2));
+        auto out = TypeParam::make_storage();
+        auto comp = [grid = TypeParam::make_grid(),
+                        coeff = TypeParam::make_const_storage(repo.coeff),
+                        in = TypeParam::make_const_storage(repo.in),
+                        &out] {
+            run(get_spec<TypeParam>(execute_forward()), TypeParam::backend(), grid, in, coeff, out);
+        };
+        comp();
+        TypeParam::verify(repo.out, out);
+        TypeParam::benchmark("horizontal_diffusion_forward", comp);
+    }
+
+    // the same computation as above, with the fields stored in single precision
+    GT_REGRESSION_TEST(horizontal_diffusion_reduced_precision, test_environment<2>, stencil_backend_t) {
+        using float_t = typename TypeParam::float_t;
+        horizontal_diffusion_repository repo(TypeParam::d(0), TypeParam::d(1), TypeParam::d(2));
+        auto out = TypeParam::template make_storage<float>();
+        auto comp = [grid = TypeParam::make_grid(),
+                        coeff = TypeParam::template make_const_storage<float>(repo.coeff),
+                        in = TypeParam::template make_const_storage<float>(repo.in),
+                        &out] {
+            run(get_spec<TypeParam>(),
+                TypeParam::backend(),
+                grid,
+                sid::widen<float_t>(in),
+                sid::widen<float_t>(coeff),
+                sid::widen<float_t>(out));
+        };
+        comp();
+        TypeParam::verify(repo.out, out);
+        TypeParam::benchmark("horizontal_diffusion_reduced_precision", comp);
+    }
 } // namespace
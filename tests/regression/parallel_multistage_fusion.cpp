@@ -51,6 +51,40 @@ namespace {
         }
     };
 
+    struct copy_functor {
+        using in = in_accessor<0>;
+        using out = inout_accessor<1>;
+
+        using param_list = make_param_list<in, out>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    struct vertical_sum {
+        using in = in_accessor<0, extent<0, 0, 0, 0, -1, 1>>;
+        using out = inout_accessor<1>;
+
+        using param_list = make_param_list<in, out>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval, full_t::modify<1, -1>) {
+            eval(out()) = eval(in(0, 0, -1)) + eval(in(0, 0, 1));
+        }
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval, full_t::first_level) {
+            eval(out()) = eval(in());
+        }
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval, full_t::last_level) {
+            eval(out()) = eval(in());
+        }
+    };
+
 #ifndef GT_STENCIL_GPU_HORIZONTAL
     GT_REGRESSION_TEST(parallel_multistage_fusion, test_environment<>, stencil_backend_t) {
         auto out = TypeParam::make_storage();
@@ -65,5 +99,28 @@ namespace {
         comp();
         TypeParam::verify([](int, int, int) { return 1; }, out);
     }
+
+    // temporaries that are read at k-offsets by later stages; the cpu_ifirst backend runs it in several k-chunks if
+    // GT_CPU_IFIRST_K_CHUNK_SIZE is set to less than the k-size, as in the *_k_chunk_* variants of this test
+    GT_REGRESSION_TEST(parallel_multistage_vertical_chain, test_environment<>, stencil_backend_t) {
+        auto in = [](int i, int j, int k) { return i + 10 * j + 100 * k; };
+        auto out = TypeParam::make_storage();
+        auto comp = [&out, in = TypeParam::make_storage(in), grid = TypeParam::make_grid()] {
+            const auto spec = [](auto in, auto out) {
+                GT_DECLARE_TMP(typename TypeParam::float_t, tmp0, tmp1);
+                return multi_pass(execute_parallel().stage(copy_functor(), in, tmp0),
+                    execute_parallel().stage(vertical_sum(), tmp0, tmp1),
+                    execute_parallel().stage(copy_with_vertical_offset(), tmp1, out));
+            };
+            run(spec, stencil_backend_t(), grid, in, out);
+        };
+        comp();
+        int k_size = TypeParam::k_size();
+        auto sum = [&](int i, int j, int k) {
+            return k == 0 || k == k_size - 1 ? in(i, j, k) : in(i, j, k - 1) + in(i, j, k + 1);
+        };
+        TypeParam::verify([&](int i, int j, int k) { return k == k_size - 1 ? sum(i, j, k) : sum(i, j, k + 1); }, out);
+        TypeParam::benchmark("parallel_multistage_vertical_chain", comp);
+    }
 #endif
 } // namespace
@@ -0,0 +1,106 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+#include <gridtools/reduction.hpp>
+#include <gridtools/stencil/cartesian.hpp>
+#include <gridtools/storage/sid.hpp>
+
+#include <reduction_select.hpp>
+#include <test_environment.hpp>
+
+namespace {
+    using namespace gridtools;
+    using namespace stencil;
+    using namespace cartesian;
+
+    struct copy_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1>;
+
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    struct square_functor {
+        using out = inout_accessor<0>;
+        using in = in_accessor<1>;
+
+        using param_list = make_param_list<out, in>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(in()) * eval(in());
+        }
+    };
+
+    GT_REGRESSION_TEST(reduce_many, test_environment<>, reduction_backend_t) {
+        using float_t = typename TypeParam::float_t;
+        auto init = [](int i, int j, int k) { return float_t(1 + (7 * i + 13 * j + 3 * k) % 17); };
+        double sum = 0, sum_sq = 0;
+        float_t min = init(0, 0, 0), max = min;
+        for (int i = 0; i < TypeParam::d(0); ++i)
+            for (int j = 0; j < TypeParam::d(1); ++j)
+                for (int k = 0; k < TypeParam::d(2); ++k) {
+                    float_t val = init(i, j, k);
+                    sum += val;
+                    sum_sq += val * val;
+                    min = std::min(min, val);
+                    max = std::max(max, val);
+                }
+
+        // the padding of the reducible is filled with 0, which must not be taken by `min`
+        auto out = reduction::make_reducible<reduction_backend_t, storage_traits_t>(
+            float_t(0), TypeParam::d(0), TypeParam::d(1), TypeParam::d(2));
+        auto in = TypeParam::make_const_storage(init);
+        auto grid = TypeParam::make_grid();
+        run_single_stage(copy_functor(), stencil_backend_t(), grid, out, in);
+        auto res =
+            reduction::reduce_many(out, reduction::plus(), reduction::min(), reduction::max(), reduction::sum_sq);
+        EXPECT_NEAR(tuple_util::get<0>(res), sum, default_precision<float_t>() * sum);
+        EXPECT_EQ(tuple_util::get<1>(res), min);
+        EXPECT_EQ(tuple_util::get<2>(res), max);
+        EXPECT_NEAR(tuple_util::get<3>(res), sum_sq, default_precision<float_t>() * sum_sq);
+
+        // norm of a stencil output without a reducible
+        auto field = TypeParam::make_storage();
+        run_single_stage(copy_functor(), stencil_backend_t(), grid, field, in);
+        EXPECT_NEAR(reduction::l2_norm(field), std::sqrt(sum_sq), default_precision<float_t>() * std::sqrt(sum_sq));
+
+        // there is no neutral value to return for an empty SID
+        auto empty = storage::builder<storage_traits_t>.template type<float_t>().dimensions(TypeParam::d(0), 0, 1)();
+        EXPECT_THROW(reduction::reduce_many(empty, reduction::plus()), std::domain_error);
+
+        TypeParam::benchmark("reduce_many_fused", [&] {
+            return reduction::reduce_many(
+                out, reduction::plus(), reduction::min(), reduction::max(), reduction::sum_sq);
+        });
+        // the same four reductions without `reduce_many`: one `reducible::reduce` pass each, the squares need a stencil
+        // of their own (the results of `min` and `max` are off because of the padding, only the time matters here)
+        auto squares = reduction::make_reducible<reduction_backend_t, storage_traits_t>(
+            float_t(0), TypeParam::d(0), TypeParam::d(1), TypeParam::d(2));
+        TypeParam::benchmark("reduce_many_separate", [&] {
+            out.reduce(reduction::plus());
+            out.reduce(reduction::min());
+            out.reduce(reduction::max());
+            run_single_stage(square_functor(), stencil_backend_t(), grid, squares, out);
+            return squares.reduce(reduction::plus());
+        });
+    }
+} // namespace
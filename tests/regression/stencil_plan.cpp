@@ -0,0 +1,74 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil/cartesian.hpp>
+
+#include <stencil_select.hpp>
+#include <test_environment.hpp>
+
+namespace {
+    using namespace gridtools;
+    using namespace stencil;
+    using namespace cartesian;
+
+    struct copy_functor {
+        using in = in_accessor<0>;
+        using out = inout_accessor<1>;
+
+        using param_list = make_param_list<in, out>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) = eval(in());
+        }
+    };
+
+    struct accumulate_functor {
+        using in = in_accessor<0, extent<0, 1>>;
+        using out = inout_accessor<1>;
+
+        using param_list = make_param_list<in, out>;
+
+        template <class Eval>
+        GT_FUNCTION static void apply(Eval &&eval) {
+            eval(out()) += eval(in(1, 0));
+        }
+    };
+
+    // the number of stencil calls per measurement, the domain size should be small to measure the launch overhead
+    constexpr int launches = 100;
+
+    GT_REGRESSION_TEST(stencil_plan, test_environment<1>, stencil_backend_t) {
+        auto spec = [](auto in, auto out) {
+            GT_DECLARE_TMP(typename TypeParam::float_t, tmp);
+            return execute_parallel().stage(copy_functor(), in, tmp).stage(accumulate_functor(), tmp, out);
+        };
+        auto in = [](int i, int j, int k) { return i + j + k; };
+        auto out = TypeParam::make_storage(0);
+        auto grid = TypeParam::make_grid();
+
+        // the input field is owned by the plan
+        auto plan = make_plan(spec, stencil_backend_t(), grid, TypeParam::make_const_storage(in), out);
+        for (int n = 0; n < 3; ++n)
+            plan.execute();
+        TypeParam::verify([&](int i, int j, int k) { return 3 * in(i + 1, j, k); }, out);
+
+        auto in_storage = TypeParam::make_const_storage(in);
+        TypeParam::benchmark("stencil_plan_run", [&] {
+            for (int n = 0; n < launches; ++n)
+                run(spec, stencil_backend_t(), grid, in_storage, out);
+        });
+        TypeParam::benchmark("stencil_plan_execute", [&] {
+            for (int n = 0; n < launches; ++n)
+                plan.execute();
+        });
+    }
+} // namespace
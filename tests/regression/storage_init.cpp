@@ -0,0 +1,43 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/storage/builder.hpp>
+
+#include <storage_select.hpp>
+#include <test_environment.hpp>
+
+using namespace gridtools;
+
+// initialization of the fields at model startup, with initializers and values
+GT_REGRESSION_TEST(storage_init, test_environment<3>, storage_traits_t) {
+    auto fun = [](int i, int j, int k) { return i + 10 * j + 100 * k; };
+    TypeParam::verify(1.5, TypeParam::make_storage(1.5));
+    TypeParam::verify(fun, TypeParam::make_storage(fun));
+
+    // an ij-field, the masked k dimension must not end up as the innermost loop of the initialization
+    auto ij_fun = [](int i, int j, int) { return i + 10 * j; };
+    auto ij_field = storage::builder<storage_traits_t>
+                        .template type<typename TypeParam::float_t>()
+                        .dimensions(TypeParam::d(0), TypeParam::d(1), TypeParam::d(2))
+                        .template selector<1, 1, 0>()
+                        .initializer(ij_fun)
+                        .build();
+    auto ij_view = ij_field->const_host_view();
+    for (int i = 0; i != TypeParam::d(0); ++i)
+        for (int j = 0; j != TypeParam::d(1); ++j)
+            for (int k = 0; k != TypeParam::d(2); ++k)
+                EXPECT_EQ(ij_view(i, j, k), ij_fun(i, j, 0)) << i << " " << j << " " << k;
+    TypeParam::benchmark("storage_init", [&] {
+        for (int n = 0; n != 4; ++n) {
+            TypeParam::make_storage(1.5);
+            TypeParam::make_storage(fun);
+        }
+    });
+}
@@ -9,7 +9,14 @@
  */
 #include <gtest/gtest.h>
 
+#include <map>
 #include <set>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 #include <gridtools/common/hugepage_alloc.hpp>
 
@@ -95,5 +102,69 @@ namespace gridtools {
 
         INSTANTIATE_TEST_SUITE_P(hugepage_alloc, hugepage_alloc_fixture, ::testing::Values("disable", "transparent"));
 
+        struct numa_mode_fixture : ::testing::TestWithParam<std::string> {
+            std::string backup_mode;
+            void SetUp() {
+                const char *backup_mode_v = std::getenv("GT_NUMA_MODE");
+                backup_mode = backup_mode_v ? backup_mode_v : "";
+                setenv("GT_NUMA_MODE", GetParam().c_str(), 1);
+            }
+            void TearDown() {
+                if (backup_mode.empty())
+                    unsetenv("GT_NUMA_MODE");
+                else
+                    setenv("GT_NUMA_MODE", backup_mode.c_str(), 1);
+            }
+        };
+
+        TEST_P(numa_mode_fixture, numa_mode_from_env) {
+            auto value = hugepage_alloc_impl_::numa_mode_from_env();
+            auto expected = hugepage_alloc_impl_::numa_mode::first_touch;
+            if (GetParam() == "interleave")
+                expected = hugepage_alloc_impl_::numa_mode::interleave;
+            else if (GetParam() == "local")
+                expected = hugepage_alloc_impl_::numa_mode::local;
+            EXPECT_EQ(value, expected);
+        }
+
+#ifdef __linux__
+        TEST_P(numa_mode_fixture, page_placement) {
+            std::size_t page_size = hugepage_alloc_impl_::page_size();
+            // with transparent huge pages, interleaving happens at huge page granularity
+            std::size_t n = 4 * hugepage_alloc_impl_::hugepage_size();
+            char *ptr = static_cast<char *>(hugepage_alloc(n));
+            std::vector<void *> pages;
+            for (std::size_t i = 0; i < n; i += page_size) {
+                ptr[i] = 1;
+                pages.push_back(ptr + i);
+            }
+
+            // query the node of each page
+            std::vector<int> status(pages.size(), -1);
+            if (syscall(SYS_move_pages, 0, pages.size(), pages.data(), nullptr, status.data(), 0)) {
+                hugepage_free(ptr);
+                GTEST_SKIP() << "move_pages is not supported";
+            }
+            std::map<int, std::size_t> pages_per_node;
+            for (int node : status) {
+                EXPECT_GE(node, 0);
+                ++pages_per_node[node];
+            }
+            for (auto const &item : pages_per_node)
+                RecordProperty("pages_on_node_" + std::to_string(item.first), item.second);
+
+            std::size_t allowed_nodes = 0;
+            for (unsigned long mask : hugepage_alloc_impl_::allowed_numa_nodes())
+                allowed_nodes += __builtin_popcountl(mask);
+            if (GetParam() == "interleave" && allowed_nodes > 1) {
+                EXPECT_GT(pages_per_node.size(), 1);
+            }
+            hugepage_free(ptr);
+        }
+#endif
+
+        INSTANTIATE_TEST_SUITE_P(
+            hugepage_alloc, numa_mode_fixture, ::testing::Values("first_touch", "interleave", "local"));
+
     } // namespace
 } // namespace gridtools
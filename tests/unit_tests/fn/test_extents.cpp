@@ -93,5 +93,26 @@ namespace gridtools::fn {
             static_assert(element_at<b, testee::sizes_t>::value == 4);
         } // namespace extents_enclosing_extents
 
+        namespace extents_sum_extents {
+            using foo = extents<extent<a, -1, 1>, extent<b, -1, 0>>;
+            using bar = extents<extent<a, -2, 0>, extent<c, 0, 3>>;
+            using testee = sum_extents<foo, bar>;
+
+            static_assert(element_at<a, testee::offsets_t>::value == -3);
+            static_assert(element_at<a, testee::sizes_t>::value == 4);
+            static_assert(element_at<b, testee::offsets_t>::value == -1);
+            static_assert(element_at<b, testee::sizes_t>::value == 1);
+            static_assert(!has_key<testee::offsets_t, c>::value);
+            static_assert(element_at<c, testee::sizes_t>::value == 3);
+            static_assert(std::is_same_v<sum_extents<>, extents<>>);
+        } // namespace extents_sum_extents
+
+        namespace extents_extent_at {
+            using testee = extents<extent<a, -1, 2>>;
+
+            static_assert(std::is_same_v<extent_at<testee, a>, extent<a, -1, 2>>);
+            static_assert(std::is_same_v<extent_at<testee, b>, extent<b, 0, 0>>);
+        } // namespace extents_extent_at
+
     } // namespace test_extents_cpp
 } // namespace gridtools::fn
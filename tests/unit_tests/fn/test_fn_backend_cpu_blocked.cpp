@@ -0,0 +1,168 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/fn/backend/cpu_blocked.hpp>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/fn/column_stage.hpp>
+#include <gridtools/sid/composite.hpp>
+#include <gridtools/sid/synthetic.hpp>
+
+namespace gridtools::fn::backend {
+    namespace {
+        using namespace literals;
+        using sid::property;
+
+        template <int I>
+        using int_t = integral_constant<int, I>;
+
+        // block sizes that do not divide the domain sizes
+        using block_sizes_t = meta::list<meta::list<int_t<0>, int_t<2>>, meta::list<int_t<2>, int_t<2>>>;
+        using backend_t = cpu_blocked<block_sizes_t>;
+
+        struct sum_scan : fwd {
+            static GT_FUNCTION constexpr auto body() {
+                return scan_pass(
+                    [](auto acc, auto const &iter) { return tuple(get<0>(acc) + *iter, get<1>(acc) * *iter); },
+                    [](auto acc) { return get<0>(acc); });
+            }
+        };
+
+        struct make_iterator_mock {
+            auto operator()() const {
+                return [](auto tag, auto const &ptr, auto const &) { return at_key<decltype(tag)>(ptr); };
+            }
+        };
+
+        struct twice_stage {
+            template <class MakeIterator, class Ptr, class Strides>
+            void operator()(MakeIterator const &, Ptr &ptr, Strides const &) const {
+                *at_key<int_t<0>>(ptr) = 2 * *at_key<int_t<1>>(ptr);
+            }
+        };
+
+        auto as_synthetic(int x[5][7][3]) {
+            return sid::synthetic()
+                .set<property::origin>(sid::host_device::simple_ptr_holder(&x[0][0][0]))
+                .set<property::strides>(tuple(21_c, 3_c, 1_c));
+        }
+
+        TEST(backend_cpu_blocked, apply_stencil_stage) {
+            int in[5][7][3], out[5][7][3] = {};
+            for (int i = 0; i < 5; ++i)
+                for (int j = 0; j < 7; ++j)
+                    for (int k = 0; k < 3; ++k)
+                        in[i][j][k] = 21 * i + 3 * j + k;
+
+            auto composite = sid::composite::keys<int_t<0>, int_t<1>>::make_values(as_synthetic(out), as_synthetic(in));
+
+            auto sizes = hymap::keys<int_t<0>, int_t<1>, int_t<2>>::values<int_t<5>, int_t<7>, int_t<3>>();
+
+            apply_stencil_stage(backend_t(), sizes, twice_stage(), make_iterator_mock(), composite);
+
+            for (int i = 0; i < 5; ++i)
+                for (int j = 0; j < 7; ++j)
+                    for (int k = 0; k < 3; ++k)
+                        EXPECT_EQ(out[i][j][k], 2 * in[i][j][k]);
+        }
+
+        TEST(backend_cpu_blocked, apply_column_stage) {
+            int in[5][7][3], out[5][7][3] = {};
+            for (int i = 0; i < 5; ++i)
+                for (int j = 0; j < 7; ++j)
+                    for (int k = 0; k < 3; ++k)
+                        in[i][j][k] = 21 * i + 3 * j + k;
+
+            auto composite = sid::composite::keys<int_t<0>, int_t<1>>::make_values(as_synthetic(out), as_synthetic(in));
+
+            auto sizes = hymap::keys<int_t<0>, int_t<1>, int_t<2>>::values<int_t<5>, int_t<7>, int_t<3>>();
+
+            column_stage<int_t<1>, sum_scan, 0, 1> cs;
+
+            apply_column_stage(backend_t(), sizes, cs, make_iterator_mock(), composite, int_t<1>(), tuple(42, 1));
+
+            for (int i = 0; i < 5; ++i)
+                for (int k = 0; k < 3; ++k) {
+                    int res = 42;
+                    for (int j = 0; j < 7; ++j) {
+                        res += in[i][j][k];
+                        EXPECT_EQ(out[i][j][k], res);
+                    }
+                }
+        }
+
+        TEST(backend_cpu_blocked, global_tmp) {
+            auto alloc = tmp_allocator(backend_t());
+            auto sizes = hymap::keys<int_t<0>, int_t<1>, int_t<2>>::values<int_t<5>, int_t<7>, int_t<3>>();
+            auto tmp = allocate_global_tmp(alloc, sizes, data_type<int>());
+            static_assert(sid::is_sid<decltype(tmp)>());
+
+            auto strides = sid::get_strides(tmp);
+            EXPECT_EQ(sid::get_stride<int_t<0>>(strides), 1);
+
+            auto ptr = sid::get_origin(tmp)();
+            for (int i = 0; i < 5; ++i) {
+                for (int j = 0; j < 7; ++j) {
+                    for (int k = 0; k < 3; ++k) {
+                        *ptr = 21 * i + 3 * j + k;
+                        sid::shift(ptr, sid::get_stride<int_t<2>>(strides), 1_c);
+                    }
+                    sid::shift(ptr, sid::get_stride<int_t<2>>(strides), -3_c);
+                    sid::shift(ptr, sid::get_stride<int_t<1>>(strides), 1_c);
+                }
+                sid::shift(ptr, sid::get_stride<int_t<1>>(strides), -7_c);
+                sid::shift(ptr, sid::get_stride<int_t<0>>(strides), 1_c);
+            }
+            sid::shift(ptr, sid::get_stride<int_t<0>>(strides), -5_c);
+
+            for (int i = 0; i < 5; ++i) {
+                for (int j = 0; j < 7; ++j) {
+                    for (int k = 0; k < 3; ++k) {
+                        EXPECT_EQ(*ptr, 21 * i + 3 * j + k);
+                        sid::shift(ptr, sid::get_stride<int_t<2>>(strides), 1_c);
+                    }
+                    sid::shift(ptr, sid::get_stride<int_t<2>>(strides), -3_c);
+                    sid::shift(ptr, sid::get_stride<int_t<1>>(strides), 1_c);
+                }
+                sid::shift(ptr, sid::get_stride<int_t<1>>(strides), -7_c);
+                sid::shift(ptr, sid::get_stride<int_t<0>>(strides), 1_c);
+            }
+            sid::shift(ptr, sid::get_stride<int_t<0>>(strides), -5_c);
+        }
+
+        TEST(backend_cpu_blocked, inner_dim) {
+            using inner_backend_t = cpu_blocked<block_sizes_t, thread_pool::dummy, int_t<1>, int_t<2>>;
+            int in[5][7][3], out[5][7][3] = {};
+            for (int i = 0; i < 5; ++i)
+                for (int j = 0; j < 7; ++j)
+                    for (int k = 0; k < 3; ++k)
+                        in[i][j][k] = 21 * i + 3 * j + k;
+
+            auto composite = sid::composite::keys<int_t<0>, int_t<1>>::make_values(as_synthetic(out), as_synthetic(in));
+
+            auto sizes = hymap::keys<int_t<0>, int_t<1>, int_t<2>>::values<int_t<5>, int_t<7>, int_t<3>>();
+
+            apply_stencil_stage(inner_backend_t(), sizes, twice_stage(), make_iterator_mock(), composite);
+
+            for (int i = 0; i < 5; ++i)
+                for (int j = 0; j < 7; ++j)
+                    for (int k = 0; k < 3; ++k)
+                        EXPECT_EQ(out[i][j][k], 2 * in[i][j][k]);
+
+            // temporaries are contiguous along the inner dimension
+            auto alloc = tmp_allocator(inner_backend_t());
+            auto tmp = allocate_global_tmp(alloc, sizes, data_type<int>());
+            auto strides = sid::get_strides(tmp);
+            EXPECT_EQ(sid::get_stride<int_t<2>>(strides), 1);
+            EXPECT_EQ(sid::get_stride<int_t<0>>(strides), 3);
+            EXPECT_EQ(sid::get_stride<int_t<1>>(strides), 15);
+        }
+    } // namespace
+} // namespace gridtools::fn::backend
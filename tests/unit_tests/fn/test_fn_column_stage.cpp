@@ -8,6 +8,7 @@
  * SPDX-License-Identifier: BSD-3-Clause
  */
 #include <gridtools/fn/column_stage.hpp>
+#include <gridtools/fn/simd_column_stage.hpp>
 
 #include <gtest/gtest.h>
 
@@ -99,5 +100,58 @@ namespace gridtools::fn {
             }
         }
 
+        TEST(simd_scan, smoke) {
+            using column_t = int[5][4];
+            using vdim_t = integral_constant<int, 0>;
+            using lane_dim_t = integral_constant<int, 1>;
+
+            column_t a = {};
+            column_t b;
+            for (int k = 0; k < 5; ++k)
+                for (int l = 0; l < 4; ++l)
+                    b[k][l] = (k + 1) * (l + 1);
+            auto composite = sid::composite::keys<integral_constant<int, 0>, integral_constant<int, 1>>::make_values(
+                sid::synthetic()
+                    .set<property::origin>(sid::host_device::simple_ptr_holder(&a[0][0]))
+                    .set<property::strides>(tuple(4_c, 1_c)),
+                sid::synthetic()
+                    .set<property::origin>(sid::host_device::simple_ptr_holder(&b[0][0]))
+                    .set<property::strides>(tuple(4_c, 1_c)));
+            auto ptr = sid::get_origin(composite)();
+            auto strides = sid::get_strides(composite);
+
+            {
+                simd_column_stage<lane_dim_t, 4, column_stage<vdim_t, sum_fold_with_logues, 0, 1>> cs;
+                auto res = cs(42, 5, make_iterator_mock()(), ptr, strides);
+                for (int l = 0; l < 4; ++l)
+                    EXPECT_EQ(get_lane(res, l), 42 + 26 * (l + 1));
+            }
+
+            {
+                simd_column_stage<lane_dim_t, 4, column_stage<vdim_t, sum_scan, 0, 1>> cs;
+                auto res = cs(tuple(42, 1), 5, make_iterator_mock()(), ptr, strides);
+                for (int l = 0; l < 4; ++l) {
+                    EXPECT_EQ(get<0>(get_lane(res, l)), 42 + 15 * (l + 1));
+                    EXPECT_EQ(get<1>(get_lane(res, l)), 120 * (l + 1) * (l + 1) * (l + 1) * (l + 1) * (l + 1));
+                    for (int k = 0; k < 5; ++k)
+                        EXPECT_EQ(a[k][l], 42 + (k + 1) * (k + 2) / 2 * (l + 1));
+                }
+            }
+
+            {
+                simd_column_stage<lane_dim_t,
+                    2,
+                    merged_column_stage<column_stage<vdim_t, sum_scan, 0, 1>, column_stage<vdim_t, sum_scan, 0, 1>>>
+                    cs;
+                auto res = cs(tuple(0, 1), 5, make_iterator_mock()(), ptr, strides);
+                for (int l = 0; l < 2; ++l) {
+                    EXPECT_EQ(get<0>(get_lane(res, l)), 2 * 15 * (l + 1));
+                    for (int k = 0; k < 5; ++k)
+                        EXPECT_EQ(a[k][l], (15 + (k + 1) * (k + 2) / 2) * (l + 1));
+                }
+                EXPECT_EQ(a[0][2], 42 + 3);
+            }
+        }
+
     } // namespace
 } // namespace gridtools::fn
@@ -0,0 +1,67 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/fn/delta_neighbor_table.hpp>
+
+#include <stdexcept>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/cpu_kfirst.hpp>
+
+namespace gridtools::fn::delta_neighbor_table {
+    namespace {
+        static_assert(neighbor_table::is_neighbor_table<delta_neighbor_table<3>>());
+
+        const auto builder = storage::builder<storage::cpu_kfirst>.type<int>();
+
+        // 1000 locations with 3 neighbors each among 2000 targets: close to the prediction, missing or far away
+        int expected(int i, int m) {
+            if (m == 0)
+                return 2 * i + 1;
+            if (m == 1)
+                return i % 7 == 0 ? -1 : 2 * i - 3;
+            return i % 100 == 0 ? (i * 997) % 2000 + 40000 : 2 * i;
+        }
+
+        TEST(delta_neighbor_table, smoke) {
+            auto src = builder.dimensions(1000, 3).initializer(expected).build();
+            auto table = make_delta_neighbor_table<3>(src->const_host_view(), 2000);
+
+            for (int i = 0; i != 1000; ++i) {
+                auto neighbors = neighbor_table::neighbors(table, i);
+                for (int m = 0; m != 3; ++m)
+                    EXPECT_EQ(neighbors[m], expected(i, m));
+                EXPECT_EQ(neighbor_table::neighbor<0>(table, i), expected(i, 0));
+                EXPECT_EQ(neighbor_table::neighbor<1>(table, i), expected(i, 1));
+                EXPECT_EQ(neighbor_table::neighbor<2>(table, i), expected(i, 2));
+            }
+            EXPECT_DOUBLE_EQ(outlier_ratio(table), 10 / 3000.);
+
+            auto copy = table;
+            EXPECT_EQ(neighbor_table::neighbor<2>(copy, 100), expected(100, 2));
+        }
+
+        TEST(delta_neighbor_table, fewer_neighbors) {
+            auto src = builder.dimensions(5, 1).value(3).build();
+            auto table = make_delta_neighbor_table<2>(src->const_host_view(), 5);
+            for (int i = 0; i != 5; ++i) {
+                EXPECT_EQ(neighbor_table::neighbor<0>(table, i), 3);
+                EXPECT_EQ(neighbor_table::neighbor<1>(table, i), -1);
+            }
+            EXPECT_EQ(outlier_ratio(table), 0);
+        }
+
+        TEST(delta_neighbor_table, too_many_neighbors) {
+            auto src = builder.dimensions(5, 3).value(3).build();
+            EXPECT_THROW(make_delta_neighbor_table<2>(src->const_host_view(), 5), std::domain_error);
+        }
+    } // namespace
+} // namespace gridtools::fn::delta_neighbor_table
@@ -25,7 +25,9 @@ namespace gridtools::fn {
 
     TEST(neighbor_table, smoke) {
         std::array<int, 2> table[3] = {{1, 2}, {3, 4}, {4, 5}};
-        for (int i = 0; i < 3; ++i)
+        for (int i = 0; i < 3; ++i) {
             EXPECT_EQ(table[i], neighbor_table::neighbors(table, i));
+            EXPECT_EQ(table[i][1], neighbor_table::neighbor<1>(table, i));
+        }
     }
 } // namespace gridtools::fn
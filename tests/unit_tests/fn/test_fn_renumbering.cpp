@@ -0,0 +1,116 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/fn/renumbering.hpp>
+
+#include <cstdlib>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/cpu_kfirst.hpp>
+
+namespace gridtools::fn::renumbering {
+    namespace {
+        const auto builder = storage::builder<storage::cpu_kfirst>.type<int>();
+
+        TEST(renumbering, permutation) {
+            permutation perm({2, 0, 1});
+            EXPECT_EQ(perm.size(), 3);
+            EXPECT_EQ(perm.new_to_old(0), 2);
+            EXPECT_EQ(perm.old_to_new(2), 0);
+            EXPECT_EQ(perm.old_to_new(0), 1);
+
+            auto inv = inverse(perm);
+            for (int i = 0; i != 3; ++i)
+                EXPECT_EQ(inv.new_to_old(i), perm.old_to_new(i));
+
+            auto id = compose(perm, inv);
+            for (int i = 0; i != 3; ++i)
+                EXPECT_EQ(id.new_to_old(i), i);
+
+            auto twice = compose(perm, perm);
+            for (int i = 0; i != 3; ++i)
+                EXPECT_EQ(twice.new_to_old(i), perm.new_to_old(perm.new_to_old(i)));
+        }
+
+        // a chain of 8 vertices connected by 7 edges, numbered in a scattered order
+        constexpr int nvertices = 8;
+        constexpr int nedges = 7;
+        constexpr int vertex_at[nvertices] = {5, 2, 7, 0, 3, 6, 1, 4};
+        constexpr int edge_at[nedges] = {3, 6, 0, 4, 1, 5, 2};
+
+        auto make_e2v() {
+            return builder.dimensions(nedges, 2)
+                .initializer([](int e, int n) {
+                    for (int i = 0; i != nedges; ++i)
+                        if (edge_at[i] == e)
+                            return vertex_at[i + n];
+                    return -1;
+                })
+                .build();
+        }
+
+        auto make_v2e() {
+            return builder.dimensions(nvertices, 2)
+                .initializer([](int v, int n) {
+                    for (int i = 0; i != nvertices; ++i)
+                        if (vertex_at[i] == v) {
+                            int e = i - 1 + n;
+                            return e >= 0 && e < nedges ? edge_at[e] : -1;
+                        }
+                    return -1;
+                })
+                .build();
+        }
+
+        TEST(renumbering, reverse_cuthill_mckee) {
+            auto e2v = make_e2v();
+            auto v2e = make_v2e();
+
+            auto adj = make_adjacency(v2e->const_host_view(), e2v->const_host_view());
+            EXPECT_EQ(adj.size(), nvertices);
+            EXPECT_EQ(adj.degree(vertex_at[0]), 1);
+            EXPECT_EQ(adj.degree(vertex_at[3]), 2);
+
+            auto vperm = reverse_cuthill_mckee(adj);
+            auto eperm = induced_permutation(e2v->const_host_view(), vperm);
+
+            auto new_e2v = builder.dimensions(nedges, 2).build();
+            permute_table(eperm, vperm, e2v->const_host_view(), new_e2v->host_view());
+            auto view = new_e2v->const_host_view();
+            for (int e = 0; e != nedges; ++e) {
+                // the chain is renumbered contiguously
+                EXPECT_EQ(std::abs(view(e, 0) - view(e, 1)), 1);
+                if (e > 0) {
+                    EXPECT_EQ(std::min(view(e, 0), view(e, 1)), std::min(view(e - 1, 0), view(e - 1, 1)) + 1);
+                }
+            }
+        }
+
+        TEST(renumbering, permute_field) {
+            auto src = builder.dimensions(4, 3).initializer([](int i, int k) { return 10 * i + k; }).build();
+            auto dst = builder.dimensions(4, 3).build();
+            auto back = builder.dimensions(4, 3).build();
+            permutation perm({3, 1, 0, 2});
+
+            permute_field(perm, src->const_host_view(), dst->host_view());
+            permute_field(inverse(perm), dst->const_host_view(), back->host_view());
+
+            auto dst_view = dst->const_host_view();
+            auto back_view = back->const_host_view();
+            for (int i = 0; i != 4; ++i)
+                for (int k = 0; k != 3; ++k) {
+                    EXPECT_EQ(dst_view(i, k), 10 * perm.new_to_old(i) + k);
+                    EXPECT_EQ(back_view(i, k), 10 * i + k);
+                }
+        }
+    } // namespace
+} // namespace gridtools::fn::renumbering
@@ -0,0 +1,76 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/fn/stage_fusion.hpp>
+
+#include <tuple>
+#include <type_traits>
+
+namespace gridtools::fn {
+    namespace {
+        struct a {};
+        struct b {};
+
+        struct pointwise {
+            using extents_t = extents<>;
+        };
+
+        struct lap {
+            using extents_t = make_extents<extent<a, -1, 1>, extent<b, -1, 1>>;
+        };
+
+        template <class D>
+        struct flux {
+            using extents_t = make_extents<extent<D, 0, 1>>;
+        };
+
+        struct div {
+            using extents_t = make_extents<extent<a, -1, 0>, extent<b, -1, 0>>;
+        };
+
+        using field_t = int *;
+
+        namespace hdiff {
+            using args_t = std::tuple<field_t, field_t, local_tmp<int>, local_tmp<int>, local_tmp<int>>;
+            using stages_t = meta::list<stencil_stage<lap, 2, 1>,
+                stencil_stage<flux<a>, 3, 1, 2>,
+                stencil_stage<flux<b>, 4, 1, 2>,
+                stencil_stage<div, 0, 1, 3, 4>>;
+            using testee = fused_stages<stages_t, args_t>;
+
+            static_assert(has_local_tmps<args_t>::value);
+            static_assert(meta::length<testee>::value == 3);
+
+            using lap_extents_t = local_tmp_extents<testee, integral_constant<int, 2>>;
+            static_assert(std::is_same_v<extent_at<lap_extents_t, a>, extent<a, -1, 1>>);
+            static_assert(std::is_same_v<extent_at<lap_extents_t, b>, extent<b, -1, 1>>);
+
+            // both fluxes are computed in the same fused stage
+            static_assert(std::is_same_v<local_tmp_extents<testee, integral_constant<int, 3>>,
+                local_tmp_extents<testee, integral_constant<int, 4>>>);
+            using flux_extents_t = local_tmp_extents<testee, integral_constant<int, 3>>;
+            static_assert(std::is_same_v<extent_at<flux_extents_t, a>, extent<a, -1, 0>>);
+            static_assert(std::is_same_v<extent_at<flux_extents_t, b>, extent<b, -1, 0>>);
+
+            using last_extents_t = typename meta::last<testee>::extents_t;
+            static_assert(std::is_same_v<extent_at<last_extents_t, a>, extent<a, 0, 0>>);
+        } // namespace hdiff
+
+        namespace pointwise_chain {
+            using args_t = std::tuple<field_t, field_t, local_tmp<int>>;
+            using stages_t = meta::list<stencil_stage<pointwise, 2, 1>, stencil_stage<pointwise, 0, 2>>;
+            using testee = fused_stages<stages_t, args_t>;
+
+            // stages with equal compute extents are merged
+            static_assert(meta::length<testee>::value == 1);
+        } // namespace pointwise_chain
+
+        static_assert(!has_local_tmps<std::tuple<field_t, field_t>>::value);
+    } // namespace
+} // namespace gridtools::fn
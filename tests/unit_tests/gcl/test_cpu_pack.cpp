@@ -0,0 +1,158 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/gcl/high_level/cpu_pack.hpp>
+
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/array.hpp>
+#include <gridtools/common/array_addons.hpp>
+#include <gridtools/gcl/high_level/descriptors.hpp>
+#include <gridtools/gcl/low_level/translate.hpp>
+
+namespace gridtools {
+    namespace gcl {
+        namespace {
+            using translate = translate_t<3>;
+
+            // different halos in all directions and padding beyond the halos
+            empty_field_no_dt make_field(int offset) {
+                empty_field_no_dt res;
+                res.add_halo(0, halo_descriptor(2, 3, 3, 12 + offset, 18 + offset));
+                res.add_halo(1, halo_descriptor(1, 2, 1, 7, 11));
+                res.add_halo(2, halo_descriptor(3, 1, 3, 8, 10));
+                return res;
+            }
+
+            std::vector<double> make_data(empty_field_no_dt const &field, double first) {
+                std::vector<double> res(
+                    field.halos[0].total_length() * field.halos[1].total_length() * field.halos[2].total_length());
+                std::iota(res.begin(), res.end(), first);
+                return res;
+            }
+
+            array<int, 3> to_eta(int n) { return {n % 3 - 1, n / 3 % 3 - 1, n / 9 - 1}; }
+
+            // the element by element copies that `pack_plane` and `unpack_plane` replace
+            void reference_pack(
+                empty_field_no_dt const &field, array<int, 3> const &eta, double const *ptr, double *&it) {
+                auto &&halos = field.halos;
+                for (int k = halos[2].loop_low_bound_inside(eta[2]); k <= halos[2].loop_high_bound_inside(eta[2]); ++k)
+                    for (int j = halos[1].loop_low_bound_inside(eta[1]); j <= halos[1].loop_high_bound_inside(eta[1]);
+                         ++j)
+                        for (int i = halos[0].loop_low_bound_inside(eta[0]);
+                             i <= halos[0].loop_high_bound_inside(eta[0]);
+                             ++i)
+                            *it++ = ptr[access(i, j, k, halos[0].total_length(), halos[1].total_length())];
+            }
+
+            void reference_unpack(empty_field_no_dt const &field, array<int, 3> const &eta, double *ptr, double *&it) {
+                auto &&halos = field.halos;
+                for (int k = halos[2].loop_low_bound_outside(eta[2]); k <= halos[2].loop_high_bound_outside(eta[2]);
+                     ++k)
+                    for (int j = halos[1].loop_low_bound_outside(eta[1]);
+                         j <= halos[1].loop_high_bound_outside(eta[1]);
+                         ++j)
+                        for (int i = halos[0].loop_low_bound_outside(eta[0]);
+                             i <= halos[0].loop_high_bound_outside(eta[0]);
+                             ++i)
+                            ptr[access(i, j, k, halos[0].total_length(), halos[1].total_length())] = *it++;
+            }
+
+            template <class T>
+            bool same_bytes(std::vector<T> const &lhs, std::vector<T> const &rhs) {
+                return lhs.size() == rhs.size() && std::memcmp(lhs.data(), rhs.data(), lhs.size() * sizeof(T)) == 0;
+            }
+
+            TEST(cpu_pack, pack) {
+                auto field = make_field(0);
+                auto data = make_data(field, 0);
+                for (int n = 0; n != 27; ++n) {
+                    auto eta = to_eta(n);
+                    if (n == 13 || field.send_buffer_size(eta) == 0)
+                        continue;
+                    std::vector<double> expected(field.send_buffer_size(eta), -1);
+                    std::vector<double> actual(expected);
+                    double *it = expected.data();
+                    reference_pack(field, eta, data.data(), it);
+                    it = actual.data();
+                    field.pack(eta, data.data(), it);
+                    EXPECT_EQ(it, actual.data() + actual.size());
+                    EXPECT_TRUE(same_bytes(expected, actual)) << eta;
+                }
+            }
+
+            TEST(cpu_pack, unpack) {
+                auto field = make_field(0);
+                for (int n = 0; n != 27; ++n) {
+                    auto eta = to_eta(n);
+                    if (n == 13 || field.recv_buffer_size(eta) == 0)
+                        continue;
+                    std::vector<double> message(field.recv_buffer_size(eta));
+                    std::iota(message.begin(), message.end(), 1e6);
+                    auto expected = make_data(field, 0);
+                    auto actual = expected;
+                    double *it = message.data();
+                    reference_unpack(field, eta, expected.data(), it);
+                    it = message.data();
+                    field.unpack(eta, actual.data(), it);
+                    EXPECT_EQ(it, message.data() + message.size());
+                    EXPECT_TRUE(same_bytes(expected, actual)) << eta;
+                }
+            }
+
+            // all the neighbors and two fields of different sizes, packed in parallel planes
+            TEST(cpu_pack, all_neighbors) {
+                empty_field_no_dt fields[] = {make_field(0), make_field(5)};
+                std::vector<double> data[] = {make_data(fields[0], 0), make_data(fields[1], 1e5)};
+                auto visit = [&](int f, auto const &fun) { fun(fields[f], data[f].data()); };
+                auto is_neighbor = [](empty_field_no_dt const &, array<int, 3> const &) { return true; };
+
+                std::vector<double> expected[27], actual[27];
+                array<double *, 27> buffers;
+                for (int n = 0; n != 27; ++n) {
+                    auto eta = to_eta(n);
+                    std::size_t size = n == 13 ? 1 : fields[0].send_buffer_size(eta) + fields[1].send_buffer_size(eta);
+                    expected[n].assign(size, -1);
+                    actual[n].assign(size, -1);
+                    buffers[n] = actual[n].data();
+                    if (n == 13)
+                        continue;
+                    double *it = expected[n].data();
+                    for (int f = 0; f != 2; ++f)
+                        reference_pack(fields[f], eta, data[f].data(), it);
+                }
+                cpu_pack<translate>(buffers, is_neighbor, 2, visit);
+                for (int n = 0; n != 27; ++n)
+                    EXPECT_TRUE(same_bytes(expected[n], actual[n])) << to_eta(n);
+
+                std::vector<double> unpacked[] = {data[0], data[1]};
+                for (int n = 0; n != 27; ++n) {
+                    auto eta = to_eta(n);
+                    std::size_t size = n == 13 ? 1 : fields[0].recv_buffer_size(eta) + fields[1].recv_buffer_size(eta);
+                    actual[n].resize(size);
+                    std::iota(actual[n].begin(), actual[n].end(), 1e6 * (n + 1));
+                    buffers[n] = actual[n].data();
+                    if (n == 13)
+                        continue;
+                    double *it = actual[n].data();
+                    for (int f = 0; f != 2; ++f)
+                        reference_unpack(fields[f], eta, unpacked[f].data(), it);
+                }
+                cpu_unpack<translate>(buffers, is_neighbor, 2, visit);
+                for (int f = 0; f != 2; ++f)
+                    EXPECT_TRUE(same_bytes(unpacked[f], data[f])) << f;
+            }
+        } // namespace
+    }     // namespace gcl
+} // namespace gridtools
@@ -0,0 +1,73 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/sid/widen.hpp>
+
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/integral_constant.hpp>
+#include <gridtools/common/tuple_util.hpp>
+#include <gridtools/sid/composite.hpp>
+#include <gridtools/sid/concept.hpp>
+#include <gridtools/sid/simple_ptr_holder.hpp>
+#include <gridtools/sid/synthetic.hpp>
+
+namespace gridtools {
+    namespace {
+        using sid::property;
+
+        struct a;
+        struct b;
+
+        TEST(widen, c_array) {
+            float data[3][4] = {};
+            auto testee = sid::widen<double>(data);
+            using testee_t = decltype(testee);
+            static_assert(is_sid<testee_t>());
+            static_assert(
+                std::is_same_v<sid::element_type<testee_t>, sid::widen_impl_::narrowing_ref<float &, double>>);
+
+            auto ptr = sid::get_origin(testee)();
+            auto strides = sid::get_strides(testee);
+            sid::shift(ptr, sid::get_stride<integral_constant<int, 0>>(strides), 1);
+            sid::shift(ptr, sid::get_stride<integral_constant<int, 1>>(strides), 2);
+            *ptr = 1.5;
+            EXPECT_EQ(1.5f, data[1][2]);
+            *ptr += 1;
+            double val = *ptr;
+            EXPECT_EQ(2.5, val);
+            EXPECT_EQ(2.5f, (*(sid::get_origin(testee) + 6)()));
+        }
+
+        TEST(widen, const_elements) {
+            float const src = 1.5f;
+            auto testee = sid::widen<double>(
+                sid::synthetic().set<property::origin>(sid::host_device::simple_ptr_holder(&src)));
+            static_assert(is_sid<decltype(testee)>());
+            static_assert(std::is_same_v<decltype(*sid::get_origin(testee)()), double>);
+            EXPECT_EQ(1.5, *sid::get_origin(testee)());
+        }
+
+        TEST(widen, composite) {
+            float const src = 42;
+            float dst = 0;
+
+            auto testee = sid::composite::keys<a, b>::make_values(
+                sid::widen<double>(sid::synthetic().set<property::origin>(sid::host_device::simple_ptr_holder(&src))),
+                sid::widen<double>(sid::synthetic().set<property::origin>(sid::host_device::simple_ptr_holder(&dst))));
+            static_assert(is_sid<decltype(testee)>());
+
+            auto refs = *sid::get_origin(testee)();
+            at_key<b>(refs) = at_key<a>(refs) / 4;
+            EXPECT_EQ(10.5f, dst);
+        }
+    } // namespace
+} // namespace gridtools
@@ -0,0 +1,129 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/stencil/cpu_ifirst/execinfo.hpp>
+
+#include <cstddef>
+#include <cstdlib>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/hugepage_alloc.hpp>
+
+namespace gridtools {
+    namespace stencil {
+        namespace cpu_ifirst_backend {
+            namespace {
+                template <int Threads>
+                struct pool {
+                    friend int thread_pool_get_max_threads(pool) { return Threads; }
+                    friend int thread_pool_get_thread_num(pool) { return 0; }
+                };
+
+                struct grid {
+                    int_t m_i_size, m_j_size;
+                    int_t i_size() const { return m_i_size; }
+                    int_t j_size() const { return m_j_size; }
+                };
+
+                // a working set of `bytes_per_point * cache_size` bytes per i-j point of the block
+                auto working_set(double bytes_per_point) {
+                    return [=](int_t i_block_size, int_t j_block_size) {
+                        return std::size_t(bytes_per_point * hugepage_alloc_impl_::l2_cache_size() * i_block_size *
+                                           j_block_size);
+                    };
+                }
+
+                class execinfo_test : public testing::Test {
+                  protected:
+                    void SetUp() override { unsetenv("GT_CPU_IFIRST_BLOCK_SIZE"); }
+                    void TearDown() override { unsetenv("GT_CPU_IFIRST_BLOCK_SIZE"); }
+                };
+
+                TEST_F(execinfo_test, split_among_threads) {
+                    execinfo testee(pool<4>(), grid{1000, 40}, working_set(0));
+                    EXPECT_EQ(testee.i_block_size(), 1000);
+                    EXPECT_EQ(testee.j_block_size(), 10);
+                    EXPECT_EQ(testee.i_blocks(), 1);
+                    EXPECT_EQ(testee.j_blocks(), 4);
+                }
+
+                TEST_F(execinfo_test, split_along_i_for_few_rows) {
+                    execinfo testee(pool<8>(), grid{1000, 2}, working_set(0));
+                    EXPECT_EQ(testee.i_block_size(), 250);
+                    EXPECT_EQ(testee.j_block_size(), 1);
+                    EXPECT_EQ(testee.i_blocks(), 4);
+                    EXPECT_EQ(testee.j_blocks(), 2);
+                }
+
+                TEST_F(execinfo_test, shrink_along_j) {
+                    // 40 rows of 1000 points are ten times the cache size
+                    execinfo testee(pool<1>(), grid{1000, 40}, working_set(1. / 4000));
+                    EXPECT_EQ(testee.i_block_size(), 1000);
+                    EXPECT_EQ(testee.j_block_size(), 3);
+                    EXPECT_EQ(testee.j_blocks(), 14);
+                }
+
+                TEST_F(execinfo_test, shrink_along_i) {
+                    // two rows of 128 points fill the cache
+                    execinfo testee(pool<1>(), grid{1000, 40}, working_set(1. / 256));
+                    EXPECT_EQ(testee.i_block_size(), 128);
+                    EXPECT_EQ(testee.j_block_size(), 2);
+                    EXPECT_EQ(testee.i_blocks(), 8);
+                    EXPECT_EQ(testee.j_blocks(), 20);
+                    auto last = testee.block(7, 19);
+                    EXPECT_EQ(last.i_block_size, 1000 - 7 * 128);
+                    EXPECT_EQ(last.j_block_size, 2);
+                }
+
+                TEST_F(execinfo_test, no_shrink_if_smallest_block_does_not_fit) {
+                    // two rows of 128 points are twice the cache size
+                    execinfo testee(pool<4>(), grid{1000, 40}, working_set(1. / 128));
+                    EXPECT_EQ(testee.i_block_size(), 1000);
+                    EXPECT_EQ(testee.j_block_size(), 10);
+                    EXPECT_EQ(testee.i_blocks(), 1);
+                    EXPECT_EQ(testee.j_blocks(), 4);
+                }
+
+                TEST_F(execinfo_test, shrink_if_smallest_block_fits) {
+                    // the same grid, two rows of 128 points are half the cache size
+                    execinfo testee(pool<4>(), grid{1000, 40}, working_set(1. / 512));
+                    EXPECT_EQ(testee.i_block_size(), 250);
+                    EXPECT_EQ(testee.j_block_size(), 2);
+                    EXPECT_EQ(testee.i_blocks(), 4);
+                    EXPECT_EQ(testee.j_blocks(), 20);
+                }
+
+                TEST_F(execinfo_test, block_size_from_env) {
+                    setenv("GT_CPU_IFIRST_BLOCK_SIZE", "64x8", 1);
+                    execinfo testee(pool<4>(), grid{1000, 40}, working_set(1));
+                    EXPECT_EQ(testee.i_block_size(), 64);
+                    EXPECT_EQ(testee.j_block_size(), 8);
+                    EXPECT_EQ(testee.i_blocks(), 16);
+                    EXPECT_EQ(testee.j_blocks(), 5);
+                }
+
+                TEST_F(execinfo_test, block_size_from_env_is_clamped) {
+                    setenv("GT_CPU_IFIRST_BLOCK_SIZE", "5000x8", 1);
+                    execinfo testee(pool<4>(), grid{1000, 5}, working_set(0));
+                    EXPECT_EQ(testee.i_block_size(), 1000);
+                    EXPECT_EQ(testee.j_block_size(), 5);
+                }
+
+                TEST_F(execinfo_test, invalid_block_size_from_env) {
+                    setenv("GT_CPU_IFIRST_BLOCK_SIZE", "64", 1);
+                    execinfo testee(pool<4>(), grid{1000, 40}, working_set(0));
+                    EXPECT_EQ(testee.i_block_size(), 1000);
+                    EXPECT_EQ(testee.j_block_size(), 10);
+                }
+            } // namespace
+        }     // namespace cpu_ifirst_backend
+    }         // namespace stencil
+} // namespace gridtools
@@ -0,0 +1,43 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/stencil/cpu_ifirst/ij_cache.hpp>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/sid/concept.hpp>
+#include <gridtools/stencil/common/extent.hpp>
+#include <gridtools/thread_pool/omp.hpp>
+
+using namespace gridtools;
+using namespace literals;
+using namespace stencil;
+using namespace cpu_ifirst_backend;
+
+TEST(ij_cache, smoke) {
+    using extent_t = extent<-1, 2, -2, 3>;
+
+    tmp_allocator allocator;
+    auto testee = make_ij_cache<double, extent_t, thread_pool::omp>(allocator, 12, 5);
+    auto tmp = make_tmp_storage<double, extent_t, false, thread_pool::omp>(allocator, {12, 5, 7});
+
+    using ij_cache_t = decltype(testee);
+
+    static_assert(is_sid<ij_cache_t>());
+    static_assert(std::is_same_v<sid::ptr_type<ij_cache_t>, double *>);
+    static_assert(!std::is_same_v<sid::strides_kind<ij_cache_t>, sid::strides_kind<decltype(tmp)>>);
+
+    auto strides = sid::get_strides(testee);
+    EXPECT_EQ(1, sid::get_stride<dim::i>(strides));
+    EXPECT_EQ(0, sid::get_stride<dim::k>(strides));
+    EXPECT_EQ(sid::get_stride<dim::j>(strides), sid::get_stride<dim::j>(sid::get_strides(tmp)) / 7);
+    EXPECT_EQ(sid::get_stride<dim::thread>(strides),
+        sid::get_stride<dim::j>(strides) * extent_t::extend(dim::j(), 5));
+}
@@ -0,0 +1,55 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/stencil/cpu_ifirst/loops.hpp>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/hymap.hpp>
+#include <gridtools/common/integral_constant.hpp>
+
+namespace gridtools {
+    namespace stencil {
+        namespace cpu_ifirst_backend {
+            namespace {
+                struct increment {
+                    template <class Strides>
+                    void operator()(int *ptr, Strides const &) const {
+                        ++*ptr;
+                    }
+                };
+
+                template <int_t Width>
+                void check_i_loop(int_t size) {
+                    int data[32] = {};
+                    int *ptr = data;
+                    auto strides = hymap::keys<dim::i>::make_values(2);
+                    loops_impl_::i_loop(integral_constant<int_t, Width>(), size, increment(), ptr, strides);
+                    EXPECT_EQ(ptr, data);
+                    for (int_t i = 0; i != 32; ++i)
+                        EXPECT_EQ(data[i], i % 2 == 0 && i / 2 < size) << "size = " << size << ", i = " << i;
+                }
+
+                TEST(i_loop, scalar) {
+                    for (int_t size : {0, 1, 7, 16})
+                        check_i_loop<1>(size);
+                }
+
+                // sizes that are not multiples of the width are finished by the remainder loop
+                TEST(i_loop, packs) {
+                    for (int_t size : {0, 3, 4, 5, 8, 13, 16}) {
+                        check_i_loop<4>(size);
+                        check_i_loop<8>(size);
+                    }
+                }
+            } // namespace
+        }     // namespace cpu_ifirst_backend
+    }         // namespace stencil
+} // namespace gridtools
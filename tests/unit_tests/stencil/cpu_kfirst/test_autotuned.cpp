@@ -0,0 +1,146 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/stencil/cpu_kfirst.hpp>
+
+#include <cstdio>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil/cartesian.hpp>
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/cpu_kfirst.hpp>
+#include <gridtools/storage/sid.hpp>
+
+namespace gridtools {
+    namespace stencil {
+        namespace cpu_kfirst_backend {
+            namespace {
+                using namespace cartesian;
+
+                struct lap {
+                    using in = in_accessor<0, extent<-1, 1, -1, 1>>;
+                    using out = inout_accessor<1>;
+
+                    using param_list = make_param_list<in, out>;
+
+                    template <class Eval>
+                    GT_FUNCTION static void apply(Eval &&eval) {
+                        eval(out()) =
+                            4 * eval(in()) - (eval(in(1, 0)) + eval(in(-1, 0)) + eval(in(0, 1)) + eval(in(0, -1)));
+                    }
+                };
+
+                constexpr int_t i_size = 37;
+                constexpr int_t j_size = 23;
+                constexpr int_t k_size = 5;
+                constexpr int_t halo = 2;
+
+                double input(int i, int j, int k) { return i * i + 3 * j + k; }
+
+                TEST(cpu_kfirst_autotuned, tuning_runs_are_correct) {
+                    auto builder = storage::builder<storage::cpu_kfirst>.type<double>().dimensions(
+                        i_size + 2 * halo, j_size + 2 * halo, k_size);
+                    auto in = builder.initializer(input)();
+                    auto out = builder.value(0)();
+                    auto grid = make_grid({halo, halo, halo, i_size + halo - 1, i_size + 2 * halo},
+                        {halo, halo, halo, j_size + halo - 1, j_size + 2 * halo},
+                        k_size);
+                    auto spec = [](auto in, auto out) {
+                        GT_DECLARE_TMP(double, tmp);
+                        return execute_parallel().stage(lap(), in, tmp).stage(lap(), tmp, out);
+                    };
+                    auto lap_ref = [](auto f, int i, int j, int k) {
+                        return 4 * f(i, j, k) - (f(i + 1, j, k) + f(i - 1, j, k) + f(i, j + 1, k) + f(i, j - 1, k));
+                    };
+                    auto lap_in = [&](int i, int j, int k) { return lap_ref(input, i, j, k); };
+
+                    auto num_tuning_runs = tuning_cache_impl_::rounds * tuning_cache_impl_::candidates().size();
+                    for (std::size_t call = 0; call <= num_tuning_runs; ++call) {
+                        run(spec, cpu_kfirst_autotuned<>(), grid, in, out);
+                        auto view = out->const_host_view();
+                        for (int i = halo; i < i_size + halo; ++i)
+                            for (int j = halo; j < j_size + halo; ++j)
+                                for (int k = 0; k < k_size; ++k)
+                                    ASSERT_DOUBLE_EQ(view(i, j, k), lap_ref(lap_in, i, j, k)) << "call = " << call;
+                    }
+                }
+
+                void tune(tuning_cache &testee, tuning_key_t const &key, std::size_t winner) {
+                    auto &candidates = tuning_cache_impl_::candidates();
+                    for (std::size_t round = 0; round < tuning_cache_impl_::rounds; ++round)
+                        for (std::size_t i = 0; i < candidates.size(); ++i) {
+                            auto [sizes, candidate] = testee.get(key);
+                            EXPECT_EQ(i, candidate);
+                            EXPECT_EQ(candidates[i].i, sizes.i);
+                            EXPECT_EQ(candidates[i].j, sizes.j);
+                            testee.report(key, candidate, candidate == winner ? 1 : 2);
+                        }
+                }
+
+                void expect_tuned(tuning_cache &testee, tuning_key_t const &key, std::size_t winner) {
+                    auto &candidates = tuning_cache_impl_::candidates();
+                    auto [sizes, candidate] = testee.get(key);
+                    EXPECT_EQ(candidates.size(), candidate);
+                    EXPECT_EQ(candidates[winner].i, sizes.i);
+                    EXPECT_EQ(candidates[winner].j, sizes.j);
+                }
+
+                using doubles = meta::list<double const, double>;
+
+                TEST(cpu_kfirst_autotuned, tuning_key) {
+                    auto key = make_tuning_key<lap, doubles>(1, 2, 3, 4);
+                    EXPECT_EQ(key, (make_tuning_key<lap, doubles>(1, 2, 3, 4)));
+                    EXPECT_NE(key, (make_tuning_key<int, doubles>(1, 2, 3, 4)));
+                    EXPECT_NE(key, (make_tuning_key<lap, doubles>(1, 2, 3, 5)));
+                    EXPECT_NE(key, (make_tuning_key<lap, meta::list<float const, float>>(1, 2, 3, 4)));
+                }
+
+                TEST(cpu_kfirst_autotuned, tuning_cache) {
+                    tuning_cache testee;
+                    auto key = make_tuning_key<lap, doubles>(1, 2, 3, 4);
+                    tune(testee, key, 2);
+                    expect_tuned(testee, key, 2);
+                }
+
+                TEST(cpu_kfirst_autotuned, tuning_cache_file) {
+                    std::string file = ::testing::TempDir() + "gt_tuning_cache_test";
+                    std::remove(file.c_str());
+                    auto key = make_tuning_key<lap, doubles>(1, 2, 3, 4);
+                    {
+                        tuning_cache testee(file);
+                        tune(testee, key, 3);
+                    }
+                    tuning_cache testee(file);
+                    expect_tuned(testee, key, 3);
+                    std::remove(file.c_str());
+                }
+
+                TEST(cpu_kfirst_autotuned, shared_tuning_cache_file) {
+                    std::string file = ::testing::TempDir() + "gt_shared_tuning_cache_test";
+                    std::remove(file.c_str());
+                    auto first = make_tuning_key<lap, doubles>(1, 2, 3, 4);
+                    auto second = make_tuning_key<lap, doubles>(5, 6, 7, 8);
+                    {
+                        tuning_cache a(file);
+                        tuning_cache b(file);
+                        tune(a, first, 1);
+                        tune(b, second, 4);
+                    }
+                    tuning_cache testee(file);
+                    expect_tuned(testee, first, 1);
+                    expect_tuned(testee, second, 4);
+                    std::remove(file.c_str());
+                }
+            } // namespace
+        }     // namespace cpu_kfirst_backend
+    }         // namespace stencil
+} // namespace gridtools
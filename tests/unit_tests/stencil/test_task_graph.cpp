@@ -0,0 +1,136 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/stencil/task_graph.hpp>
+
+#include <vector>
+
+#if defined(_OPENMP)
+#include <omp.h>
+#endif
+
+#include <gtest/gtest.h>
+
+#include <gridtools/stencil/cartesian.hpp>
+#include <gridtools/stencil/cpu_kfirst.hpp>
+#include <gridtools/stencil/global_parameter.hpp>
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/cpu_kfirst.hpp>
+#include <gridtools/storage/sid.hpp>
+
+namespace gridtools {
+    namespace stencil {
+        namespace {
+            using namespace cartesian;
+
+            struct scale {
+                using in = in_accessor<0>;
+                using factor = in_accessor<1>;
+                using out = inout_accessor<2>;
+
+                using param_list = make_param_list<in, factor, out>;
+
+                template <class Eval>
+                GT_FUNCTION static void apply(Eval &&eval) {
+                    eval(out()) = eval(factor()) * eval(in());
+                }
+            };
+
+            constexpr int_t size = 12;
+
+            auto make_storage(double value) {
+                return storage::builder<storage::cpu_kfirst>.dimensions(size, size, size).type<double>().value(value)();
+            }
+
+            auto grid = make_grid(size, size, size);
+
+            template <class... Fields>
+            void add_scale(task_graph &graph, Fields &&...fields) {
+                graph.add(
+                    [](auto in, auto factor, auto out) { return execute_parallel().stage(scale(), in, factor, out); },
+                    cpu_kfirst<>(),
+                    grid,
+                    std::forward<Fields>(fields)...);
+            }
+
+            TEST(task_graph, dependencies) {
+                auto a = make_storage(1);
+                auto b = make_storage(0);
+                auto c = make_storage(0);
+                auto d = make_storage(0);
+                auto two = global_parameter(2.);
+
+                task_graph testee;
+                add_scale(testee, a, two, b); // 0: b = 2a
+                add_scale(testee, a, two, c); // 1: c = 2a
+                add_scale(testee, b, two, d); // 2: d = 2b
+                add_scale(testee, c, two, a); // 3: a = 2c
+                add_scale(testee, d, two, b); // 4: b = 2d
+
+                ASSERT_EQ(testee.size(), 5);
+                EXPECT_EQ(testee.predecessors(0), std::vector<std::size_t>{});
+                EXPECT_EQ(testee.predecessors(1), std::vector<std::size_t>{});
+                EXPECT_EQ(testee.predecessors(2), std::vector<std::size_t>{0});
+                EXPECT_EQ(testee.predecessors(3), (std::vector<std::size_t>{0, 1}));
+                EXPECT_EQ(testee.predecessors(4), (std::vector<std::size_t>{0, 2}));
+            }
+
+            template <class Storages>
+            void check(Storages const &storages, double factor) {
+                for (std::size_t i = 0; i != storages.size(); ++i) {
+                    auto view = storages[i]->const_host_view();
+                    for (int_t x = 0; x != size; ++x)
+                        for (int_t y = 0; y != size; ++y)
+                            for (int_t z = 0; z != size; ++z)
+                                EXPECT_EQ(view(x, y, z), factor * i);
+                }
+            }
+
+            void execute_tracers() {
+                constexpr int tracers = 8;
+                std::vector<decltype(make_storage(0))> in, tmp, out, last;
+                for (int i = 0; i != tracers; ++i) {
+                    in.push_back(make_storage(i));
+                    tmp.push_back(make_storage(0));
+                    out.push_back(make_storage(0));
+                    last.push_back(make_storage(0));
+                }
+                auto two = global_parameter(2.);
+                auto three = global_parameter(3.);
+
+                task_graph testee;
+                for (int i = 0; i != tracers; ++i) {
+                    add_scale(testee, in[i], two, tmp[i]);
+                    add_scale(testee, tmp[i], three, out[i]);
+                }
+                for (int step = 0; step != 3; ++step)
+                    testee.execute();
+                check(out, 6);
+
+                // the graph can still grow after it was executed
+                for (int i = 0; i != tracers; ++i)
+                    add_scale(testee, out[i], two, last[i]);
+                testee.execute();
+                check(last, 12);
+            }
+
+            TEST(task_graph, execute) { execute_tracers(); }
+
+#if defined(_OPENMP)
+            // more OpenMP threads than there are cores, so that the tasks are run concurrently everywhere
+            TEST(task_graph, execute_concurrently) {
+                int threads = omp_get_max_threads();
+                omp_set_num_threads(4);
+                execute_tracers();
+                omp_set_num_threads(threads);
+            }
+#endif
+        } // namespace
+    }     // namespace stencil
+} // namespace gridtools
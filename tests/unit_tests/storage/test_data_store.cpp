@@ -58,6 +58,40 @@ TEST(DataStoreTest, LambdaInitializer) {
                 EXPECT_DOUBLE_EQ(view(i, j, k), i + j + k);
 }
 
+TEST(DataStoreTest, LambdaInitializer4D) {
+    auto ds = builder.dimensions(9, 17, 3, 2)
+                  .initializer([](int i, int j, int k, int l) { return i + 100 * j + 10000 * k + 1000000 * l; })
+                  .build();
+    auto lengths = ds->lengths();
+    auto view = ds->host_view();
+    for (uint_t i = 0; i < lengths[0]; ++i)
+        for (uint_t j = 0; j < lengths[1]; ++j)
+            for (uint_t k = 0; k < lengths[2]; ++k)
+                for (uint_t l = 0; l < lengths[3]; ++l)
+                    EXPECT_DOUBLE_EQ(view(i, j, k, l), i + 100 * j + 10000 * k + 1000000 * l);
+}
+
+TEST(DataStoreTest, MaskedInitializer) {
+    auto ds = builder.dimensions(5, 6, 7).selector<1, 0, 1>().initializer([](int i, int j, int k) {
+        return i + 10 * j + 100 * k;
+    })();
+    auto view = ds->host_view();
+    for (int i = 0; i < 5; ++i)
+        for (int k = 0; k < 7; ++k)
+            EXPECT_DOUBLE_EQ(view(i, 0, k), i + 50 + 100 * k);
+}
+
+#ifdef GT_STORAGE_CPU_KFIRST
+TEST(DataStoreTest, ZeroInitialized) {
+    auto ds = builder.dimensions(9, 17, 3).build();
+    auto view = ds->const_host_view();
+    for (int i = 0; i < 9; ++i)
+        for (int j = 0; j < 17; ++j)
+            for (int k = 0; k < 3; ++k)
+                EXPECT_EQ(view(i, j, k), 0);
+}
+#endif
+
 TEST(DataStoreTest, Naming) {
     auto builder = ::builder.dimensions(10, 11, 12);
     // no naming
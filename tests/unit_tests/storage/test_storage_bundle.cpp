@@ -0,0 +1,90 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/storage/bundle.hpp>
+
+#include <cstdint>
+#include <type_traits>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/sid/concept.hpp>
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/cpu_ifirst.hpp>
+#include <gridtools/storage/cpu_kfirst.hpp>
+#include <gridtools/storage/sid.hpp>
+
+namespace gridtools::storage {
+    namespace {
+        const auto ifirst = builder<cpu_ifirst>.type<double>().dimensions(5, 6, 7).halos(1, 1, 0);
+
+        std::uintptr_t address(double const &ref) { return reinterpret_cast<std::uintptr_t>(&ref); }
+
+        TEST(bundle, separate_fields) {
+            auto fields = build_bundle<3>(
+                ifirst.name("f").initializer([](int i, int j, int k) { return i + 10 * j + 100 * k; }), 128);
+            auto ref = ifirst.build();
+            using field_t = std::decay_t<decltype(fields[0])>;
+            static_assert(is_sid<field_t>());
+            static_assert(std::is_same_v<sid::strides_kind<field_t>, sid::strides_kind<decltype(ref)>>);
+
+            for (int f = 0; f != 3; ++f) {
+                EXPECT_EQ(fields[f]->name(), "f_" + std::to_string(f));
+                EXPECT_EQ(fields[f]->strides(), ref->strides());
+                auto view = fields[f]->const_host_view();
+                EXPECT_EQ(address(view(1, 1, 0)) % 64, 0);
+                EXPECT_EQ(view(4, 5, 6), 4 + 50 + 600);
+            }
+            for (int f = 1; f != 3; ++f) {
+                auto end = address(fields[f - 1]->const_host_view()(4, 5, 6)) + sizeof(double);
+                auto begin = address(fields[f]->const_host_view()(0, 0, 0));
+                EXPECT_GE(begin, end + 128);
+                EXPECT_LT(begin, end + 128 + 2 * 64 + ref->strides()[1] * sizeof(double));
+            }
+        }
+
+        TEST(bundle, interleaved_fields) {
+            auto fields = build_bundle<2, interleaved_fields>(builder<cpu_kfirst>.type<double>().dimensions(5, 6, 7));
+            auto ref = builder<cpu_kfirst>.type<double>().dimensions(5, 6, 7).build();
+            using field_t = std::decay_t<decltype(fields[0])>;
+            static_assert(!std::is_same_v<sid::strides_kind<field_t>, sid::strides_kind<decltype(ref)>>);
+
+            // the i-planes of both fields alternate
+            EXPECT_EQ(fields[0]->strides()[0], 2 * ref->strides()[0]);
+            EXPECT_EQ(fields[0]->strides()[1], ref->strides()[1]);
+            EXPECT_EQ(fields[0]->strides()[2], ref->strides()[2]);
+            auto a = fields[0]->host_view();
+            auto b = fields[1]->host_view();
+            EXPECT_EQ(address(b(0, 0, 0)) - address(a(0, 0, 0)), ref->strides()[0] * sizeof(double));
+
+            for (int i = 0; i != 5; ++i)
+                for (int j = 0; j != 6; ++j)
+                    for (int k = 0; k != 7; ++k) {
+                        a(i, j, k) = i + 10 * j + 100 * k;
+                        b(i, j, k) = -1;
+                    }
+            for (int i = 0; i != 5; ++i)
+                for (int j = 0; j != 6; ++j)
+                    for (int k = 0; k != 7; ++k) {
+                        EXPECT_EQ(a(i, j, k), i + 10 * j + 100 * k);
+                        EXPECT_EQ(b(i, j, k), -1);
+                    }
+        }
+
+        TEST(bundle, lifetime) {
+            auto field = build_bundle<4>(ifirst.value(1.5))[2];
+            EXPECT_EQ(field->const_host_view()(4, 5, 6), 1.5);
+        }
+
+        TEST(bundle, outside_of_bundle) {
+            auto field = builder<bundled<cpu_ifirst>>.type<double>().dimensions(5, 6, 7).value(2.5).build();
+            EXPECT_EQ(field->const_host_view()(4, 5, 6), 2.5);
+        }
+    } // namespace
+} // namespace gridtools::storage
@@ -0,0 +1,109 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/storage/checkpoint.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/storage/builder.hpp>
+#include <gridtools/storage/cpu_ifirst.hpp>
+#include <gridtools/storage/cpu_kfirst.hpp>
+
+namespace gridtools::storage {
+    namespace {
+        struct checkpoint_test : testing::Test {
+            std::string path =
+                testing::TempDir() + "gt_checkpoint_" + testing::UnitTest::GetInstance()->current_test_info()->name();
+
+            ~checkpoint_test() { std::remove(path.c_str()); }
+        };
+
+        double f(int i, int j, int k) { return 100 * i + 10 * j + k; }
+
+        const auto ifirst = builder<cpu_ifirst>.type<double>().dimensions(13, 6, 7).halos(1, 1, 0);
+        const auto kfirst = builder<cpu_kfirst>.type<double>().dimensions(13, 6, 7);
+
+        template <class DataStorePtr>
+        void expect_f(DataStorePtr const &ds, double offset = 0) {
+            auto view = ds->const_host_view();
+            for (int i = 0; i != 13; ++i)
+                for (int j = 0; j != 6; ++j)
+                    for (int k = 0; k != 7; ++k)
+                        EXPECT_EQ(view(i, j, k), f(i, j, k) + offset);
+        }
+
+        TEST_F(checkpoint_test, same_layout) {
+            {
+                checkpoint_writer writer(path);
+                writer.write(ifirst.initializer(f).build());
+                writer.write(builder<cpu_ifirst>.type<int>().dimensions(3).value(42).build());
+                writer.write(ifirst.initializer([](int i, int j, int k) { return f(i, j, k) + 1; }).build());
+            }
+            auto first = ifirst.build();
+            auto second = builder<cpu_ifirst>.type<int>().dimensions(3).build();
+            auto third = ifirst.build();
+            checkpoint_reader reader(path);
+            reader.read(first);
+            reader.read(second);
+            reader.read(third);
+            expect_f(first);
+            expect_f(third, 1);
+            for (int i = 0; i != 3; ++i)
+                EXPECT_EQ(second->const_host_view()(i), 42);
+        }
+
+        TEST_F(checkpoint_test, other_layout) {
+            checkpoint_writer(path).write(ifirst.initializer(f).build());
+            auto ds = kfirst.build();
+            checkpoint_reader(path).read(ds);
+            expect_f(ds);
+        }
+
+        TEST_F(checkpoint_test, mismatch) {
+            checkpoint_writer(path).write(ifirst.value(0).build());
+            EXPECT_THROW(
+                checkpoint_reader(path).read(builder<cpu_ifirst>.type<double>().dimensions(13, 6, 8).build()),
+                std::runtime_error);
+            EXPECT_THROW(checkpoint_reader(path).read(builder<cpu_ifirst>.type<float>().dimensions(13, 6, 7).build()),
+                std::runtime_error);
+            checkpoint_reader reader(path);
+            reader.read(ifirst.build());
+            EXPECT_THROW(reader.read(ifirst.build()), std::runtime_error);
+        }
+
+        TEST_F(checkpoint_test, name_mismatch) {
+            checkpoint_writer(path).write(ifirst.name("a").value(0).build());
+            EXPECT_THROW(checkpoint_reader(path).read(ifirst.name("b").build()), std::runtime_error);
+            checkpoint_reader(path).read(ifirst.name("a").build());
+        }
+
+        TEST_F(checkpoint_test, truncated) {
+            checkpoint_writer(path).write(ifirst.value(0).build());
+            std::filesystem::resize_file(path, std::filesystem::file_size(path) - 8);
+            try {
+                checkpoint_reader(path).read(ifirst.build());
+                FAIL() << "truncated record was read";
+            } catch (std::runtime_error const &e) {
+                EXPECT_NE(std::string(e.what()).find("unexpected end of file"), std::string::npos) << e.what();
+            }
+            std::filesystem::resize_file(path, 16);
+            try {
+                checkpoint_reader(path).read(ifirst.build());
+                FAIL() << "truncated header was read";
+            } catch (std::runtime_error const &e) {
+                EXPECT_NE(std::string(e.what()).find("unexpected end of file"), std::string::npos) << e.what();
+            }
+        }
+    } // namespace
+} // namespace gridtools::storage
@@ -0,0 +1,98 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+#include <gridtools/storage/cpu_mmap.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <stdexcept>
+#include <string>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/storage/builder.hpp>
+
+namespace gridtools::storage {
+    namespace {
+        struct mmap_test : testing::Test {
+            std::string path =
+                testing::TempDir() + "gt_mmap_" + testing::UnitTest::GetInstance()->current_test_info()->name();
+
+            mmap_test() { std::remove(path.c_str()); }
+            ~mmap_test() { std::remove(path.c_str()); }
+        };
+
+        const auto shared = builder<cpu_mmap<>>.type<double>().dimensions(5, 6, 7).halos(1, 1, 0);
+        const auto priv = builder<cpu_mmap<cpu_ifirst, false>>.type<double>().dimensions(5, 6, 7).halos(1, 1, 0);
+
+        double f(int i, int j, int k) { return 100 * i + 10 * j + k; }
+
+        TEST_F(mmap_test, anonymous) {
+            auto ds = shared.value(2.5).build();
+            auto view = ds->const_host_view();
+            EXPECT_EQ(view(4, 5, 6), 2.5);
+        }
+
+        TEST_F(mmap_test, empty) {
+            auto anonymous = traits::allocate<cpu_mmap<>, double>(0);
+            EXPECT_EQ(anonymous.get(), nullptr);
+            auto named = traits::allocate<cpu_mmap<>, double>(0, path);
+            EXPECT_EQ(named.get(), nullptr);
+        }
+
+        TEST_F(mmap_test, same_layout_as_traits) {
+            auto ds = shared.name(path).initializer(f).build();
+            auto ref = builder<cpu_ifirst>.type<double>().dimensions(5, 6, 7).halos(1, 1, 0).build();
+            EXPECT_EQ(ds->strides(), ref->strides());
+            EXPECT_EQ(reinterpret_cast<std::uintptr_t>(&ds->const_host_view()(1, 1, 0)) % 64, 0);
+        }
+
+        TEST_F(mmap_test, attach) {
+            {
+                auto ds = shared.name(path).initializer(f).build();
+                flush(*ds);
+            }
+            auto ds = shared.name(path).build();
+            auto view = ds->host_view();
+            for (int i = 0; i != 5; ++i)
+                for (int j = 0; j != 6; ++j)
+                    for (int k = 0; k != 7; ++k)
+                        EXPECT_EQ(view(i, j, k), f(i, j, k));
+            view(1, 2, 3) = -1;
+            flush(*ds);
+            ds.reset();
+
+            auto copy = priv.name(path).build();
+            EXPECT_EQ(copy->const_host_view()(1, 2, 3), -1);
+        }
+
+        TEST_F(mmap_test, private_mapping) {
+            shared.name(path).initializer(f).build();
+            {
+                auto ds = priv.name(path).build();
+                auto view = ds->host_view();
+                EXPECT_EQ(view(1, 2, 3), f(1, 2, 3));
+                view(1, 2, 3) = -1;
+            }
+            auto ds = priv.name(path).build();
+            EXPECT_EQ(ds->const_host_view()(1, 2, 3), f(1, 2, 3));
+        }
+
+        TEST_F(mmap_test, missing_file) {
+            auto ds = priv.name(path).build();
+            EXPECT_EQ(ds->const_host_view()(4, 5, 6), 0);
+        }
+
+        TEST_F(mmap_test, size_mismatch) {
+            shared.name(path).value(0).build();
+            auto other_size = builder<cpu_mmap<>>.type<double>().dimensions(5, 6, 8).name(path);
+            EXPECT_THROW(other_size.build(), std::runtime_error);
+        }
+    } // namespace
+} // namespace gridtools::storage
@@ -0,0 +1,111 @@
+/*
+ * GridTools
+ *
+ * Copyright (c) 2014-2023, ETH Zurich
+ * All rights reserved.
+ *
+ * Please, refer to the LICENSE file in the root directory.
+ * SPDX-License-Identifier: BSD-3-Clause
+ */
+
+#include <gridtools/thread_pool/work_stealing.hpp>
+
+#include <atomic>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include <gridtools/common/integral_constant.hpp>
+#include <gridtools/thread_pool/concept.hpp>
+
+namespace gridtools {
+    namespace thread_pool {
+        namespace {
+            work_stealing pool;
+
+            TEST(work_stealing, max_threads) { EXPECT_GE(get_max_threads(pool), 1); }
+
+            TEST(work_stealing, loop_1d) {
+                std::vector<std::atomic<int>> hits(1000);
+                std::atomic<bool> valid_thread_nums(true);
+                parallel_for_loop(
+                    pool,
+                    [&](int i) {
+                        ++hits[i];
+                        int thread_num = get_thread_num(pool);
+                        if (thread_num < 0 || thread_num >= get_max_threads(pool))
+                            valid_thread_nums = false;
+                    },
+                    1000);
+                for (auto &&hit : hits)
+                    EXPECT_EQ(hit, 1);
+                EXPECT_TRUE(valid_thread_nums);
+                EXPECT_EQ(get_thread_num(pool), 0);
+            }
+
+            TEST(work_stealing, loop_2d) {
+                std::vector<std::atomic<int>> hits(7 * 13);
+                parallel_for_loop(
+                    pool, [&](int i, int j) { ++hits[i + 7 * j]; }, integral_constant<int, 7>(), 13);
+                for (auto &&hit : hits)
+                    EXPECT_EQ(hit, 1);
+            }
+
+            TEST(work_stealing, loop_3d) {
+                std::vector<std::atomic<int>> hits(5 * 3 * 11);
+                parallel_for_loop(
+                    pool, [&](int i, int j, int k) { ++hits[i + 5 * (j + 3 * k)]; }, 5, 3, 11);
+                for (auto &&hit : hits)
+                    EXPECT_EQ(hit, 1);
+            }
+
+            TEST(work_stealing, empty_loop) {
+                parallel_for_loop(
+                    pool, [&](int) { ADD_FAILURE(); }, 0);
+                parallel_for_loop(
+                    pool, [&](int, int) { ADD_FAILURE(); }, 4, 0);
+            }
+
+            TEST(work_stealing, imbalanced_loop) {
+                std::atomic<long> sum(0);
+                parallel_for_loop(
+                    pool,
+                    [&](int i) {
+                        long res = 0;
+                        for (int n = 0; n < (i < 10 ? 100000 : 1); ++n)
+                            res += n % 3;
+                        sum += res + i;
+                    },
+                    100);
+                EXPECT_EQ(sum, 10 * 99999 + 4950);
+            }
+
+            TEST(work_stealing, nested_loop) {
+                std::vector<std::atomic<int>> hits(16 * 16);
+                parallel_for_loop(
+                    pool,
+                    [&](int i) {
+                        int outer = get_thread_num(pool);
+                        parallel_for_loop(
+                            pool,
+                            [&](int j) {
+                                ++hits[i * 16 + j];
+                                EXPECT_EQ(get_thread_num(pool), outer);
+                            },
+                            16);
+                    },
+                    16);
+                for (auto &&hit : hits)
+                    EXPECT_EQ(hit, 1);
+            }
+
+            TEST(work_stealing, repeated_loops) {
+                std::atomic<int> count(0);
+                for (int n = 0; n < 1000; ++n)
+                    parallel_for_loop(
+                        pool, [&](int) { ++count; }, 8);
+                EXPECT_EQ(count, 8000);
+            }
+        } // namespace
+    }     // namespace thread_pool
+} // namespace gridtools